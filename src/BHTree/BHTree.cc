@@ -14,8 +14,12 @@
 
 #include "BHTree.h"
 
+// Root octant: padding factor and min. side (um)
+static const fp_t BHTREE_ROOT_PAD = FP_T(1.0 + 1e-6);
+static const fp_t BHTREE_ROOT_MIN = FP_T(1e-6);
+
 // Checking if it's external or not.
-bool BHTree::isExternal(const std::shared_ptr<BHTree>& bht)
+bool BHTree::isExternal(const BHTree* bht) const
 {
     if (!bht->uNE && !bht->uNW && 
         !bht->uSE && !bht->uSW && 
@@ -29,7 +33,7 @@ bool BHTree::isExternal(const std::shared_ptr<BHTree>& bht)
 }
 
 // Self checking version
-bool BHTree::isExternal()
+bool BHTree::isExternal() const
 {
     if (!this->uNE && !this->uNW &&
         !this->uSE && !this->uSW &&
@@ -43,143 +47,219 @@ bool BHTree::isExternal()
 }
 
 // Empty node?
-bool BHTree::isEmpty()
+bool BHTree::isEmpty() const
 {
-    if (!this->tree_carrier) return true;
+    if (!this->bucket) return true;
     else return false;
 }
 
+// Branch by octant part index
+//
+// uNE, uNW, uSE, uSW, lNE, lNW, lSE, lSW
+// are mapped to...
+// 0, 1, 2, 3, 4, 5, 6, 7
+//
+BHTree*& BHTree::branch(const int& part)
+{
+    switch (part) {
+        case 0: return uNE;
+        case 1: return uNW;
+        case 2: return uSE;
+        case 3: return uSW;
+        case 4: return lNE;
+        case 5: return lNW;
+        case 6: return lSE;
+        default: return lSW;
+    }
+}
+BHTree* const& BHTree::branch(const int& part) const
+{
+    switch (part) {
+        case 0: return uNE;
+        case 1: return uNW;
+        case 2: return uSE;
+        case 3: return uSW;
+        case 4: return lNE;
+        case 5: return lNW;
+        case 6: return lSE;
+        default: return lSW;
+    }
+}
 
 // Insert a carrier
 //
-// TODO: first try... make this thing non-recursive.
+// Leaves hold up to leaf_size carriers. If another carrier arrives,
+// all of them are pushed down to sub octants.
 //
 int BHTree::insert(const spCarrier& carrier)
 {
-    // Just put down a carrier if current tree is empty.
-    if (this->tree_carrier == nullptr) {
-        this->tree_carrier = carrier;
-        return 0;
+    this->n_carriers++;
+
+    if (this->isExternal()) {
+        // Room left, or can't divide anymore... just keep it here.
+        if (this->n_carriers <= this->arena->leaf_size || \
+            this->depth >= this->arena->max_depth) {
+            auto item = this->arena->bucket_items.Alloc();
+            item->carrier = &carrier;
+            item->next = this->bucket;
+            this->bucket = item;
+            return 0;
+        }
+
+        // Push down the carriers we've been holding.
+        auto resident = this->bucket;
+        this->bucket = nullptr;
+        for (; resident; resident = resident->next)
+            this->insert_to_branch(*resident->carrier);
     }
 
-    // make a sub_Octant
-    auto carrier_loc = this->current_octant->GetOctantPart(carrier);
+    return this->insert_to_branch(carrier);
+}
 
-    // uNE, uNW, uSE, uSW, lNE, lNW, lSE, lSW
-    // are mapped to...
-    // 0, 1, 2, 3, 4, 5, 6, 7
+// Inserts a carrier into proper branch
+int BHTree::insert_to_branch(const spCarrier& carrier)
+{
+    auto carrier_loc = this->current_octant.GetOctantPart(carrier);
+    auto& node_to_insert = this->branch(carrier_loc);
+
+    if (!node_to_insert) {
+        node_to_insert = this->arena->NewNode(
+            this->current_octant.SubOctant(carrier_loc),
+            this->depth + 1,
+            carrier_loc);
+    }
 
-    // At first, we need to find the last viable external node.
-    auto node_to_insert = std::make_shared<BHTree>(*this);
-    auto depth = 0;
-    spOctant octant_for_new_node = nullptr;
-    while(node_to_insert) {
-        carrier_loc = node_to_insert->GetOctant()->GetOctantPart(carrier);
-        switch (carrier_loc) {
-            case 0:
-                octant_for_new_node = node_to_insert->GetOctant()->uNE();
-                node_to_insert = node_to_insert->GetuNE();
-                break;
-            case 1:
-                octant_for_new_node = node_to_insert->GetOctant()->uNW();
-                node_to_insert = node_to_insert->GetuNW();
-                break;
-            case 2:
-                octant_for_new_node = node_to_insert->GetOctant()->uSE();
-                node_to_insert = node_to_insert->GetuSE();
-                break;
-            case 3:
-                octant_for_new_node = node_to_insert->GetOctant()->uSW();
-                node_to_insert = node_to_insert->GetuSW();
-                break;
-            case 4:
-                octant_for_new_node = node_to_insert->GetOctant()->lNE();
-                node_to_insert = node_to_insert->GetlNE();
-                break;
-            case 5:
-                octant_for_new_node = node_to_insert->GetOctant()->lNW();
-                node_to_insert = node_to_insert->GetlNW();
-                break;
-            case 6:
-                octant_for_new_node = node_to_insert->GetOctant()->lSE();
-                node_to_insert = node_to_insert->GetlSE();
-                break;
-            case 7:
-                octant_for_new_node = node_to_insert->GetOctant()->lSW();
-                node_to_insert = node_to_insert->GetlSW();
-                break;
+    return node_to_insert->insert(carrier);
+}
+
+// Calculates charge moments (bottom to top)
+void BHTree::UpdateMoments()
+{
+    this->q_neg = FP_T(0.0);
+    this->q_pos = FP_T(0.0);
+    fp_t neg_x = FP_T(0.0), neg_y = FP_T(0.0), neg_z = FP_T(0.0);
+    fp_t pos_x = FP_T(0.0), pos_y = FP_T(0.0), pos_z = FP_T(0.0);
+
+    auto add_charge = [&](const fp_t& q, const Loc& c) {
+        if (q < FP_T(0.0)) {
+            this->q_neg += q;
+            neg_x += q*c.x; neg_y += q*c.y; neg_z += q*c.z;
+        }
+        else {
+            this->q_pos += q;
+            pos_x += q*c.x; pos_y += q*c.y; pos_z += q*c.z;
         }
-        depth++;
+    };
+
+    for (auto item = this->bucket; item; item = item->next)
+        add_charge((*item->carrier)->GetCharge(), (*item->carrier)->GetPos());
+
+    for (auto part = 0; part < 8; ++part) {
+        auto& node = this->branch(part);
+        if (!node) continue;
+        node->UpdateMoments();
+        neg_x += node->q_neg*node->c_neg.x;
+        neg_y += node->q_neg*node->c_neg.y;
+        neg_z += node->q_neg*node->c_neg.z;
+        pos_x += node->q_pos*node->c_pos.x;
+        pos_y += node->q_pos*node->c_pos.y;
+        pos_z += node->q_pos*node->c_pos.z;
+        this->q_neg += node->q_neg;
+        this->q_pos += node->q_pos;
     }
 
-    // Now, assign a new node...
-    switch (carrier_loc) {
-        case 0:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 1:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 2:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 3:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 4:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 5:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 6:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
-        case 7:
-            node_to_insert = std::make_shared<BHTree>(
-                octant_for_new_node,
-                depth,
-                carrier_loc);
-            break;
+    this->c_neg = this->current_octant.GetCenter();
+    this->c_pos = this->current_octant.GetCenter();
+    if (this->q_neg != FP_T(0.0))
+        this->c_neg = Loc{ neg_x/this->q_neg, neg_y/this->q_neg, neg_z/this->q_neg };
+    if (this->q_pos != FP_T(0.0))
+        this->c_pos = Loc{ pos_x/this->q_pos, pos_y/this->q_pos, pos_z/this->q_pos };
+}
+
+// Collects groups of at most group_size carriers.
+void BHTree::CollectGroups(
+    const uint64_t& group_size,
+    std::vector<const BHTree*>& groups) const
+{
+    if (!this->n_carriers) return;
+
+    if (this->n_carriers <= group_size || this->isExternal()) {
+        groups.push_back(this);
+        return;
     }
 
-    return 0;
+    for (auto part = 0; part < 8; ++part) {
+        auto& node = this->branch(part);
+        if (node) node->CollectGroups(group_size, groups);
+    }
 }
-// direct insertion version
-int BHTree::insert(Carrier carrier)
+
+// Collects all carriers in this node and below.
+void BHTree::CollectCarriers(CarrierVector& carriers) const
 {
-    return insert(std::make_shared<Carrier>(carrier));
+    for (auto item = this->bucket; item; item = item->next)
+        carriers.push_back(*item->carrier);
+
+    for (auto part = 0; part < 8; ++part) {
+        auto& node = this->branch(part);
+        if (node) node->CollectCarriers(carriers);
+    }
 }
 
+// Distance from a point to a box (zero if inside)
+static fp_t dist_to_box(const Loc& pt, const Loc& b_min, const Loc& b_max)
+{
+    fp_t dx = fp_max<fp_t>(FP_T(0.0), b_min.x - pt.x, pt.x - b_max.x);
+    fp_t dy = fp_max<fp_t>(FP_T(0.0), b_min.y - pt.y, pt.y - b_max.y);
+    fp_t dz = fp_max<fp_t>(FP_T(0.0), b_min.z - pt.z, pt.z - b_max.z);
+    return sqrt(dx*dx + dy*dy + dz*dz);
+}
 
-// Setting up ID
-void BHTree::SetID()
+// Builds interaction list for a group.
+void BHTree::BuildInteractionList(
+    const Loc& g_min, const Loc& g_max,
+    const fp_t& alpha,
+    InteractionList& list) const
 {
-    // Cannot set ID without a carrier.
-    if (!current_octant)
+    if (!this->n_carriers) return;
+
+    // Leaves: carriers go in as they are.
+    if (this->isExternal()) {
+        for (auto item = this->bucket; item; item = item->next)
+            list.push((*item->carrier)->GetPos(), (*item->carrier)->GetCharge());
+        return;
+    }
+
+    // Check if the node is far enough for every member of the group.
+    auto oct_len = this->current_octant.GetLength();
+    auto oct_len_max = fp_max<fp_t>(oct_len.x, oct_len.y, oct_len.z);
+
+    bool far_enough = true;
+    if (this->q_neg != FP_T(0.0) && \
+        !(oct_len_max < alpha*dist_to_box(this->c_neg, g_min, g_max)))
+        far_enough = false;
+    if (this->q_pos != FP_T(0.0) && \
+        !(oct_len_max < alpha*dist_to_box(this->c_pos, g_min, g_max)))
+        far_enough = false;
+
+    if (far_enough) {
+        if (this->q_neg != FP_T(0.0)) list.push(this->c_neg, this->q_neg);
+        if (this->q_pos != FP_T(0.0)) list.push(this->c_pos, this->q_pos);
         return;
+    }
 
+    // Otherwise, open it up.
+    ++list.n_opened;
+    for (auto part = 0; part < 8; ++part) {
+        auto& node = this->branch(part);
+        if (node) node->BuildInteractionList(g_min, g_max, alpha, list);
+    }
+}
+
+
+// Tree ID: built on demand.
+std::string BHTree::GetID() const
+{
     std::stringstream ss;
     std::string branch_dir_str;
 
@@ -218,9 +298,7 @@ void BHTree::SetID()
 
     ss << "D" << this->depth << "BD" << branch_dir_str;
 
-    this->ID = ss.str();
-
-    return;
+    return ss.str();
 }
 
 // String output
@@ -230,22 +308,16 @@ std::string BHTree::to_string() const
 
     if (!(uNE && uNW && uSE && uSW && lNE && lNW && lSE && lSW)) {
         ss << "External Case!!";
-        if (tree_carrier) {
+        if (bucket) {
             ss << " Holding: " \
-                << this->tree_carrier->GetID();
+                << this->n_carriers << " carrier(s)";
         }
         else {
             ss << " Holding No Carrier.";
         }
     }
     else {
-        if (tree_carrier) {
-            ss << " Holding: " \
-                << this->tree_carrier->GetID();
-        }
-        else {
-            ss << " Holding No Carrier.";
-        }
+        ss << " Holding No Carrier.";
         ss << std::endl;
         ss << "---------------------------" << std::endl;
 
@@ -275,9 +347,6 @@ std::string BHTree::to_string() const
 // Delete all branches
 void BHTree::ResetAll()
 {
-    tree_carrier = nullptr;
-    current_octant = nullptr;
-
     uNE = nullptr;
     uNW = nullptr;
     uSE = nullptr;
@@ -287,132 +356,98 @@ void BHTree::ResetAll()
     lSE = nullptr;
     lSW = nullptr;
 
-    // this->current_octant.reset();
-
-    // this->uNE.reset();
-    // this->uNW.reset();
-    // this->uSE.reset();
-    // this->uSW.reset();
-    // this->lNE.reset();
-    // this->lNW.reset();
-    // this->lSE.reset();
-    // this->lSW.reset();
+    bucket = nullptr;
+    n_carriers = 0;
+    q_neg = FP_T(0.0);
+    q_pos = FP_T(0.0);
 }
 
-// Assignment operators
-BHTree& BHTree::operator= (const BHTree& other)
+// (Re)initialize a node from the arena
+void BHTree::Init(
+    BHTreeArena* node_arena,
+    const Octant& oct, uint64_t ndepth, short bdir)
 {
-    BHTree tmp(other);
-    *this = std::move(tmp);
-    return *this;
+    this->ResetAll();
+    arena = node_arena;
+    current_octant = oct;
+    depth = ndepth;
+    branch_direction = bdir;
 }
 
-BHTree& BHTree::operator= (BHTree&& other) noexcept
+// Hands out a new node
+BHTree* BHTreeArena::NewNode(const Octant& oct, uint64_t ndepth, short bdir)
 {
-    this->ResetAll();
-
-    this->tree_carrier = other.GetCarrier();
-    this->current_octant = other.GetOctant();
-    this->depth = other.GetDepth();
-    this->branch_direction = other.GetDirection();
-
-    this->uNE = other.GetuNE();
-    this->uNW = other.GetuNW();
-    this->uSE = other.GetuSE();
-    this->uSW = other.GetuSW();
-    this->lNE = other.GetlNE();
-    this->lNW = other.GetlNW();
-    this->lSE = other.GetlSE();
-    this->lSW = other.GetlSW();
-
-    this->ID = other.GetID();
-
-    other.ResetAll();
-
-    return *this;
+    auto node = this->nodes.Alloc();
+    node->Init(this, oct, ndepth, bdir);
+    return node;
 }
 
 
-
 /**
  *
  * Constructors and Destructors
  *
 **/
 BHTree::BHTree() : \
-    tree_carrier(nullptr),
-    current_octant(nullptr),
-    uNE(nullptr),
+    current_octant(),
+    depth(0),
+    branch_direction(-1),
+    arena(nullptr),
     uNW(nullptr),
-    uSE(nullptr),
+    uNE(nullptr),
     uSW(nullptr),
-    lNE(nullptr),
+    uSE(nullptr),
     lNW(nullptr),
-    lSE(nullptr),
+    lNE(nullptr),
     lSW(nullptr),
-    ID({}),
-    depth(0)
-{
-}
-
-BHTree::BHTree(Octant oct, uint64_t ndepth, short bdir) : BHTree::BHTree()
-{
-    current_octant = std::make_shared<Octant>(oct);
-    depth = ndepth;
-    branch_direction = bdir;
-    SetID();
-}
-
-BHTree::BHTree(spOctant spoct, uint64_t ndepth, short bdir) : BHTree::BHTree()
+    lSE(nullptr),
+    bucket(nullptr),
+    n_carriers(0),
+    q_neg(FP_T(0.0)),
+    q_pos(FP_T(0.0)),
+    c_neg(ZeroLoc),
+    c_pos(ZeroLoc)
 {
-    current_octant = spoct;
-    depth = ndepth;
-    branch_direction = bdir;
-    SetID();
 }
 
-BHTree::BHTree(const BHTree& other) :
-    tree_carrier(other.GetCarrier()),
-    current_octant(other.GetOctant()),
-    depth(other.GetDepth()),
-    branch_direction(other.GetDirection()),
-    uNE(other.GetuNE()),
-    uNW(other.GetuNW()),
-    uSE(other.GetuSE()),
-    uSW(other.GetuSW()),
-    lNE(other.GetlNE()),
-    lNW(other.GetlNW()),
-    lSE(other.GetlSE()),
-    lSW(other.GetlSW()),
-    ID(other.GetID())
-{
-}
 
-BHTree::BHTree(BHTree&& other) noexcept :
-    tree_carrier(other.GetCarrier()),
-    current_octant(other.GetOctant()),
-    depth(other.GetDepth()),
-    branch_direction(other.GetDirection()),
-    ID(other.GetID())
+// Smallest cube holding all carriers
+//
+// The sensor box is millimetres wide while the cloud is micrometres,
+// so a root fitted to the cloud skips all the empty levels above it.
+//
+Octant CloudOctant(const CarrierList& carriers)
 {
-    this->uNE = other.GetuNE();
-    this->uNW = other.GetuNW();
-    this->uSE = other.GetuSE();
-    this->uSW = other.GetuSW();
-    this->lNE = other.GetlNE();
-    this->lNW = other.GetlNW();
-    this->lSE = other.GetlSE();
-    this->lSW = other.GetlSW();
-
-    other.ResetAll();
-}
+    if (carriers.empty())
+        return Octant(Dim{ FP_T(1.0), FP_T(1.0), FP_T(1.0) }, ZeroLoc);
+
+    auto c_min = carriers.front()->GetPos();
+    auto c_max = c_min;
+    for (auto& carrier : carriers) {
+        auto pos = carrier->GetPos();
+        c_min = Loc{
+            fp_min<fp_t>(c_min.x, pos.x),
+            fp_min<fp_t>(c_min.y, pos.y),
+            fp_min<fp_t>(c_min.z, pos.z) };
+        c_max = Loc{
+            fp_max<fp_t>(c_max.x, pos.x),
+            fp_max<fp_t>(c_max.y, pos.y),
+            fp_max<fp_t>(c_max.z, pos.z) };
+    }
 
-BHTree::~BHTree()
-{
-    ResetAll();
+    // A bit larger so carriers on the faces stay inside.
+    auto side = fp_max<fp_t>(
+        c_max.x - c_min.x, c_max.y - c_min.y, c_max.z - c_min.z);
+    side = side*BHTREE_ROOT_PAD + BHTREE_ROOT_MIN;
+
+    return Octant(
+        Dim{ side, side, side },
+        Loc{
+            (c_max.x + c_min.x) / FP_T(2.0),
+            (c_max.y + c_min.y) / FP_T(2.0),
+            (c_max.z + c_min.z) / FP_T(2.0) });
 }
 
-
 // Attaching to ostream to print out information
 std::ostream& operator<< (std::ostream& os, const BHTree& bhtree)
 {
@@ -19,74 +19,156 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include "Octant.h"
 #include "carrier.h"
 #include "typedefs.h"
+#include "interaction_list.h"
+#include "slab_arena.h"
 
 // some typedefs
 using spOctant = std::shared_ptr<Octant>;
 //using spBHTree = std::shared_ptr<BHTree>;
 
+// Carriers per leaf before it splits
+static const uint64_t BHTREE_LEAF_SIZE_DEF = 8;
+
+// Depth limit of the tree. Leaves at this depth (i.e. carriers sitting
+// on top of each other) take any number of carriers.
+static const uint64_t BHTREE_MAX_DEPTH_DEF = 48;
+
+class BHTree;
+
+// Carriers in a leaf bucket: a singly linked list from the arena.
+struct BHTreeBucketItem {
+    const spCarrier* carrier;
+    BHTreeBucketItem* next;
+};
+
+// Per step storage of tree nodes. Reset it before building a new tree.
+struct BHTreeArena {
+    SlabArena<BHTree> nodes;
+    SlabArena<BHTreeBucketItem> bucket_items;
+
+    // Leaf capacity and depth limit of trees built here
+    uint64_t leaf_size;
+    uint64_t max_depth;
+
+    BHTreeArena() : \
+        leaf_size(BHTREE_LEAF_SIZE_DEF),
+        max_depth(BHTREE_MAX_DEPTH_DEF)
+    {;}
+
+    void Reset()
+    {
+        nodes.Reset();
+        bucket_items.Reset();
+    }
+
+    // New node: octant bounds live in the node itself.
+    BHTree* NewNode(const Octant& oct, uint64_t ndepth=0, short bdir=-1);
+};
+
 /**
  *
  * The Barnes-Hut tree Implementation
  *
+ * Nodes are owned by a BHTreeArena and carriers are referenced
+ * (not owned) from the carrier list, so the carrier list must not
+ * change while the tree is in use.
+ *
 **/
 class BHTree
 {
 private:
-    spCarrier tree_carrier;
-    spOctant  current_octant;
+    Octant    current_octant;
     uint64_t  depth;
     short branch_direction;
 
+    // The arena this node came from
+    BHTreeArena* arena;
+
     // branches
-    std::shared_ptr<BHTree> uNW;
-    std::shared_ptr<BHTree> uNE;
-    std::shared_ptr<BHTree> uSW;
-    std::shared_ptr<BHTree> uSE;
-    std::shared_ptr<BHTree> lNW;
-    std::shared_ptr<BHTree> lNE;
-    std::shared_ptr<BHTree> lSW;
-    std::shared_ptr<BHTree> lSE;
-
-    // ID string
-    std::string ID;
+    BHTree* uNW;
+    BHTree* uNE;
+    BHTree* uSW;
+    BHTree* uSE;
+    BHTree* lNW;
+    BHTree* lNE;
+    BHTree* lSW;
+    BHTree* lSE;
+
+    // Carriers of a leaf (up to leaf_size, any at the depth limit)
+    BHTreeBucketItem* bucket;
+
+    // Number of carriers in this node and below.
+    uint64_t n_carriers;
+
+    // Charge moments: negative and positive charges are kept apart
+    // so a neutral electron-hole cloud still has sensible centers.
+    fp_t q_neg;
+    fp_t q_pos;
+    Loc c_neg;
+    Loc c_pos;
+
+    // Branch by octant part index (see Octant::GetOctantPart)
+    BHTree*& branch(const int& part);
+    BHTree* const& branch(const int& part) const;
+
+    // Inserts a carrier into proper branch (makes one if needed)
+    int insert_to_branch(const spCarrier& carrier);
 
 public:
     // If other branch nodes are nulls, then the Octant represents
     // a single body and it is called "External."
-    bool isExternal(const std::shared_ptr<BHTree>& bht);
-    bool isExternal();
+    bool isExternal(const BHTree* bht) const;
+    bool isExternal() const;
 
     // Empty node?
-    bool isEmpty();
+    bool isEmpty() const;
 
     // Inserting a carrier into the BHTree
+    // --> carrier must be an element of the carrier list.
     int insert(const spCarrier& carrier);
-    int insert(Carrier carrier);
+
+    // Calculates charge moments of all nodes (call after insertion)
+    void UpdateMoments();
+
+    // Number of carriers in this node and below.
+    uint64_t GetNumCarriers() const
+    { return n_carriers; }
+
+    // Collects nodes holding at most group_size carriers as groups.
+    void CollectGroups(
+        const uint64_t& group_size,
+        std::vector<const BHTree*>& groups) const;
+
+    // Collects all carriers in this node and below.
+    void CollectCarriers(CarrierVector& carriers) const;
+
+    // Builds interaction list for a group bounded by (g_min, g_max).
+    // Nodes satisfying (node length / distance) < alpha goes in as
+    // monopoles, others are opened down to carriers.
+    void BuildInteractionList(
+        const Loc& g_min, const Loc& g_max,
+        const fp_t& alpha,
+        InteractionList& list) const;
 
     // Emit current tree information as string.
     std::string to_string() const;
 
-    // Setting up Tree ID
-    void SetID();
-
     // Returns Tree ID (or info.)
-    std::string GetID() const
-    { return ID; }
+    std::string GetID() const;
 
-    // Returns carrier pointer
-    spCarrier& GetCarrier()
-    { return tree_carrier; }
-    const spCarrier& GetCarrier() const
-    { return tree_carrier; }
+    // Returns carriers of a leaf
+    bool HasCarriers() const
+    { return bucket != nullptr; }
+    const BHTreeBucketItem* GetCarriers() const
+    { return bucket; }
 
-    // Returns Octant pointer
-    spOctant& GetOctant()
-    { return current_octant; }
-    const spOctant& GetOctant() const
+    // Returns Octant
+    const Octant& GetOctant() const
     { return current_octant; }
 
     // Returns depth
@@ -98,21 +180,22 @@ public:
     { return branch_direction; }
 
     // Accessing branches...
-    std::shared_ptr<BHTree> GetuNW() const { return uNW; }
-    std::shared_ptr<BHTree> GetuNE() const { return uNE; }
-    std::shared_ptr<BHTree> GetuSW() const { return uSW; }
-    std::shared_ptr<BHTree> GetuSE() const { return uSE; }
-    std::shared_ptr<BHTree> GetlNW() const { return lNW; }
-    std::shared_ptr<BHTree> GetlNE() const { return lNE; }
-    std::shared_ptr<BHTree> GetlSW() const { return lSW; }
-    std::shared_ptr<BHTree> GetlSE() const { return lSE; }
+    BHTree* GetuNW() const { return uNW; }
+    BHTree* GetuNE() const { return uNE; }
+    BHTree* GetuSW() const { return uSW; }
+    BHTree* GetuSE() const { return uSE; }
+    BHTree* GetlNW() const { return lNW; }
+    BHTree* GetlNE() const { return lNE; }
+    BHTree* GetlSW() const { return lSW; }
+    BHTree* GetlSE() const { return lSE; }
 
     // Delete all branches and carriers
     void ResetAll();
 
-    // Assignment operators
-    BHTree& operator= (const BHTree& other);
-    BHTree& operator= (BHTree&& other) noexcept;
+    // (Re)initialize a node handed out by the arena.
+    void Init(
+        BHTreeArena* node_arena,
+        const Octant& oct, uint64_t ndepth=0, short bdir=-1);
 
     /**
      *
@@ -120,17 +203,17 @@ public:
      *
     **/
     BHTree();
-    BHTree(Octant oct, uint64_t ndepth=0, short bdir=-1);
-    BHTree(spOctant spoct, uint64_t ndepth=0, short bdir=-1);
+    BHTree(const BHTree& other) = default;
+    BHTree& operator= (const BHTree& other) = default;
 
-    BHTree(const BHTree& other);
-    BHTree(BHTree&& other) noexcept;
-
-    virtual ~BHTree();
+    virtual ~BHTree() {;}
 };
 
 // Integrating with ostream
 std::ostream& operator<< (std::ostream& os, const BHTree& bhtree);
 
+// Smallest cube holding all carriers: root octant of a new tree.
+Octant CloudOctant(const CarrierList& carriers);
+
 
 #endif /* Include guard */
@@ -55,7 +55,7 @@ std::shared_ptr<Octant> Octant::NewOctant(const spCarrier& some_carrier)
     z_rel = fp_lt<fp_t>(rel_loc.z, FP_T(0.0));
 
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = ZeroLoc;
 
     // Now, deal with 8 cases.
@@ -131,62 +131,44 @@ std::shared_ptr<Octant> Octant::NewOctant(const spCarrier& some_carrier)
 // Returns a proper octant location for given carrier
 int Octant::GetOctantPart(const spCarrier& carrier) const
 {
-    // Determine some_carrier's location from
-    // center of this Octant.
-    auto rel_loc = carrier->GetPos() - this->center;
-
-    // determining relative pos
-    // --> True: positive side,
-    // --> False: negative side,
-    //
-    bool x_rel, y_rel, z_rel;
-    x_rel = fp_lt<fp_t>(rel_loc.x, FP_T(0.0));
-    y_rel = fp_lt<fp_t>(rel_loc.y, FP_T(0.0));
-    z_rel = fp_lt<fp_t>(rel_loc.z, FP_T(0.0));
-
+    return GetOctantPart(carrier->GetPos());
+}
+int Octant::GetOctantPart(const Loc& some_coord) const
+{
     // uNE, uNW, uSE, uSW, lNE, lNW, lSE, lSW
     // are mapped to...
     // 0, 1, 2, 3, 4, 5, 6, 7
     //
-    if (x_rel && y_rel && z_rel)
-    {
-        return 0;
-    }
-    else if (x_rel && y_rel && !z_rel)
-    {
-        return 1;
-    }
-    else if (x_rel && !y_rel && z_rel)
-    {
-        return 2;
-    }
-    else if (!x_rel && y_rel && z_rel)
-    {
-        return 3;
-    }
-    else if (!x_rel && y_rel && z_rel)
-    {
-        return 4;
-    }
-    else if (!x_rel && y_rel && !z_rel)
-    {
-        return 5;
-    }
-    else if (!x_rel && !y_rel && z_rel)
-    {
-        return 6;
-    }
-    else if (!x_rel && !y_rel && !z_rel)
-    {
-        return 7;
-    }
+    // i.e. bit 0: west (x < center), bit 1: south (y < center),
+    // bit 2: lower (z < center)
+    //
+    int part = 0;
+    if (some_coord.x < center.x) part |= 1;
+    if (some_coord.y < center.y) part |= 2;
+    if (some_coord.z < center.z) part |= 4;
+
+    return part;
+}
+
+// Sub octant by part index (see GetOctantPart)
+Octant Octant::SubOctant(const int& part) const
+{
+    // Same bit pattern as GetOctantPart: set bit -> lower half.
+    auto new_len = this->length / 2.0;
+    auto new_len_adj = new_len / 2.0;
+    auto new_center = Loc{
+        (part & 1) ? center.x - new_len_adj.x : center.x + new_len_adj.x,
+        (part & 2) ? center.y - new_len_adj.y : center.y + new_len_adj.y,
+        (part & 4) ? center.z - new_len_adj.z : center.z + new_len_adj.z
+    };
+    return Octant(new_len, new_center);
 }
 
 // Generate octant by force.
 std::shared_ptr<Octant> Octant::uNE() const // 111
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x + new_len_adj.x,
         center.y + new_len_adj.y,
@@ -197,7 +179,7 @@ std::shared_ptr<Octant> Octant::uNE() const // 111
 std::shared_ptr<Octant> Octant::uNW() const // 011
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x - new_len_adj.x,
         center.y + new_len_adj.y,
@@ -208,7 +190,7 @@ std::shared_ptr<Octant> Octant::uNW() const // 011
 std::shared_ptr<Octant> Octant::uSE() const // 101
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x + new_len_adj.x,
         center.y - new_len_adj.y,
@@ -219,7 +201,7 @@ std::shared_ptr<Octant> Octant::uSE() const // 101
 std::shared_ptr<Octant> Octant::uSW() const // 001
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x - new_len_adj.x,
         center.y - new_len_adj.y,
@@ -230,7 +212,7 @@ std::shared_ptr<Octant> Octant::uSW() const // 001
 std::shared_ptr<Octant> Octant::lNE() const // 110
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x + new_len_adj.x,
         center.y + new_len_adj.y,
@@ -241,7 +223,7 @@ std::shared_ptr<Octant> Octant::lNE() const // 110
 std::shared_ptr<Octant> Octant::lNW() const // 010
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x - new_len_adj.x,
         center.y + new_len_adj.y,
@@ -252,7 +234,7 @@ std::shared_ptr<Octant> Octant::lNW() const // 010
 std::shared_ptr<Octant> Octant::lSE() const // 100
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x + new_len_adj.x,
         center.y - new_len_adj.y,
@@ -263,7 +245,7 @@ std::shared_ptr<Octant> Octant::lSE() const // 100
 std::shared_ptr<Octant> Octant::lSW() const // 000
 {
     auto new_len = this->length / 2.0;
-    auto new_len_adj = new_len / 4.0;
+    auto new_len_adj = new_len / 2.0;
     auto new_center = Loc{
         center.x - new_len_adj.x,
         center.y - new_len_adj.y,
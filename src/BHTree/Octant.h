@@ -72,6 +72,10 @@ public:
 
     // Returns a proper octant location for given carrier
     int GetOctantPart(const spCarrier& carrier) const;
+    int GetOctantPart(const Loc& some_coord) const;
+
+    // Sub octant by part index.
+    Octant SubOctant(const int& part) const;
 
     // Generate octant by force.
     std::shared_ptr<Octant> uNE() const;
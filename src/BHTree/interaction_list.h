@@ -0,0 +1,86 @@
+/**
+ *
+ * interaction_list.h
+ *
+ * Shared interaction list for grouped Barnes-Hut traversal.
+ * Far nodes (as charge monopoles) and near carriers are stored as
+ * plain arrays so the whole group can be evaluated with a simple
+ * vectorizable loop.
+ *
+ * For the single precision kernel, the sources are also kept as float
+ * offsets from an anchor (center of the tile or group) with charges in
+ * units of q_h, so the float differences stay well conditioned.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __interaction_list_h__
+#define __interaction_list_h__
+
+#include <vector>
+#include <cstdint>
+
+#include "fputils.h"
+#include "physical_constants.h"
+
+class InteractionList
+{
+public:
+    // Source positions (um) and charges (C)
+    std::vector<fp_t> x;
+    std::vector<fp_t> y;
+    std::vector<fp_t> z;
+    std::vector<fp_t> q;
+
+    // Single precision copy: offsets (um) from anchor, charges (q_h)
+    std::vector<float> fx;
+    std::vector<float> fy;
+    std::vector<float> fz;
+    std::vector<float> fq;
+    Loc anchor;
+
+    // Tree nodes opened while building the list
+    uint64_t n_opened;
+
+    // Number of sources
+    size_t size() const
+    { return q.size(); }
+
+    // Wipe out sources but keep memory
+    void clear()
+    {
+        x.clear(); y.clear(); z.clear(); q.clear();
+        fx.clear(); fy.clear(); fz.clear(); fq.clear();
+        n_opened = 0;
+    }
+
+    // Add a point source
+    void push(const Loc& pos, const fp_t& charge)
+    {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        z.push_back(pos.z);
+        q.push_back(charge);
+    }
+
+    // Fill single precision copy around given anchor
+    void to_float(const Loc& center)
+    {
+        anchor = center;
+        auto n = size();
+        fx.resize(n); fy.resize(n); fz.resize(n); fq.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            fx[i] = static_cast<float>(x[i] - anchor.x);
+            fy[i] = static_cast<float>(y[i] - anchor.y);
+            fz[i] = static_cast<float>(z[i] - anchor.z);
+            fq[i] = static_cast<float>(q[i] / q_h);
+        }
+    }
+
+    InteractionList() : n_opened(0) {;}
+    virtual ~InteractionList() {;}
+
+}; /* class InteractionList */
+
+#endif /* Include guard */
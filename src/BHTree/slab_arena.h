@@ -0,0 +1,91 @@
+/**
+ *
+ * slab_arena.h
+ *
+ * A simple per-step object arena. Objects are handed out from
+ * contiguous slabs and are never freed one by one. Reset() just
+ * rewinds the slabs, so the whole arena can be recycled in O(1)
+ * at the beginning of the next step.
+ *
+ * Objects stay constructed between steps: users re-initialize
+ * whatever they get from Alloc().
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __slab_arena_h__
+#define __slab_arena_h__
+
+#include <vector>
+#include <cstdint>
+
+template <typename T>
+class SlabArena
+{
+private:
+    // Slabs never grow after creation, so pointers stay valid.
+    std::vector<std::vector<T>> slabs;
+
+    // Objects used in the last slab
+    size_t used;
+
+    // Objects handed out since last Reset()
+    size_t n_alloc;
+
+    // Minimum slab size
+    size_t min_slab;
+
+    void new_slab(const size_t& n)
+    {
+        this->slabs.emplace_back(n > this->min_slab ? n : this->min_slab);
+        this->used = 0;
+    }
+
+public:
+    // Get an object. Never returns nullptr.
+    T* Alloc()
+    {
+        if (this->slabs.empty() || \
+            this->used == this->slabs.back().size()) {
+            this->new_slab(this->n_alloc);
+        }
+        ++this->n_alloc;
+        return &this->slabs.back()[this->used++];
+    }
+
+    // Rewind the arena. If last step needed more than one slab,
+    // they are merged into one slab sized from last step's count.
+    void Reset()
+    {
+        if (this->slabs.size() > 1) {
+            auto n_total = this->Capacity();
+            this->slabs.clear();
+            this->new_slab(n_total + n_total/4);
+        }
+        this->used = 0;
+        this->n_alloc = 0;
+    }
+
+    // Objects handed out since last Reset()
+    size_t Size() const
+    { return this->n_alloc; }
+
+    // Total objects available
+    size_t Capacity() const
+    {
+        size_t n = 0;
+        for (auto& slab : this->slabs) n += slab.size();
+        return n;
+    }
+
+    SlabArena(const size_t& min_slab_size = 1024) : \
+        used(0),
+        n_alloc(0),
+        min_slab(min_slab_size ? min_slab_size : 1)
+    {;}
+    virtual ~SlabArena() {;}
+
+}; /* class SlabArena */
+
+#endif /* Include guard */
@@ -27,66 +27,45 @@
  * Public part
  *
 **/
+fp_t Carrier::type_mass[2] = { m_elec, m_elec };
 
-void Carrier::setType()
-{
-    if (fp_lt<fp_t>(this->charge, FP_T(0.0))) {
-        this->CarrType = "Electron";
-    }
-    else {
-        this->CarrType = "Hole";
-    }
-
-    return;
-}
-
-void Carrier::setType(const std::string& new_type)
-{
-    if (str_to_lower(new_type) != "electron" || str_to_lower(new_type) != "hole") {
-        std::cerr << "Carrier::setType: Can't determine type!! must be electron or hole!!" << std::endl;
-        exit(-1);
-    }
-
-    this->CarrType = new_type;
-}
-
-void Carrier::setID()
-{
-    this->setType();
-    this->CarrID = std::string(
-        std::string("[") + fp_t_to_string(this->index) +
-        std::string("]") + this->CarrType);
-}
 
 void Carrier::setMass()
 {
     // A super crude way to set mass. Don't use it if 
     // a proper way to estimate electric field.
-    if (this->CarrType == "Electron") {
-        this->mass = \
-            m_elec*(1.045 + 4.5 * 1e-4)*300.0;
+    if (this->type == CARR_T_ELECTRON) {
+        this->SetMass(
+            m_elec*(1.045 + 4.5 * 1e-4)*300.0);
     }
-    else if (this->CarrType == "Hole") {
-        this->mass = \
+    else {
+        this->SetMass(
             m_elec*(0.523 + 1.4e-3 * 300.0 - \
-                1.48e-6 * 300.0 * 300.0);
+                1.48e-6 * 300.0 * 300.0));
     }
 }
 
 void Carrier::SetType(std::string typestr)
 {
-    if (typestr == "Electron")
-        this->SetCharge(q_e);
-    else if (typestr == "Hole")
-        this->SetCharge(q_h);
+    typestr = str_to_lower(typestr);
+    if (typestr == "electron")
+        this->type = CARR_T_ELECTRON;
+    else if (typestr == "hole")
+        this->type = CARR_T_HOLE;
     else {
         std::cerr << \
             "Carrier: Invalid carrier type." << \
             " Either provide Electron or Hole!!!" << \
             std::endl;
-        this->SetCharge(FP_T(0.0));
+        this->type = CARR_T_ELECTRON;
     }
-    this->setType();
+}
+
+// ID string, i.e. [12]Electron
+std::string Carrier::GetID() const
+{
+    return std::string("[") + std::to_string(this->index) + \
+        std::string("]") + this->GetType();
 }
 
 // Returns Pos/Vel/Force as string.
@@ -121,13 +100,6 @@ std::string Carrier::GetForceStr() const
 
 }
 
-short Carrier::GetTypeI()
-{
-    if (fp_lt(this->charge, FP_T(0.0))) return CARR_T_ELECTRON;
-    else if (fp_mt(this->charge, FP_T(0.0))) return CARR_T_HOLE;
-    else return 100;
-}
-
 //
 // Force calculation methods
 //
@@ -138,78 +110,36 @@ short Carrier::GetTypeI()
  *
 **/
 Carrier::Carrier() : \
-    charge(FP_T(0.0)),
     position(ZeroLoc),
-    velocity(ZeroVel),
-    force(ZeroForce),
+    force(Force{ 0, 0, 0 }),
+    velocity(CarrVec{ 0, 0, 0 }),
+#ifdef __COMPENSATED__
+    position_c(ZeroLoc),
+    force_c(Force{ 0, 0, 0 }),
+#endif
     index(0),
-    mass(m_elec),
-    CarrID({}),
-    CarrType({})
+    type(CARR_T_ELECTRON)
 {
-    this->setID();
 }
 
 Carrier::Carrier(
     std::string carrier_type,
-    Loc position,
-    Vel velocity,
+    const Loc& position,
+    const Vel& velocity,
     fp_t mass,
     uint64_t carr_num) : Carrier()
 {
-    this->SetPos(position);
-    this->SetVel(velocity);
-    this->SetMass(mass);
-    this->SetIndex(carr_num);
-
-    if (carrier_type == "hole")
-        this->SetCharge(q_h);
-    else if (carrier_type == "electron")
-        this->SetCharge(q_e);
-    else
-        this->SetCharge(q_e);
-
-    this->setID();
+    this->Set(carrier_type, position, velocity, mass, carr_num);
 }
 
 Carrier::Carrier(
     fp_t charge,
-    Loc position,
-    Vel velocity,
+    const Loc& position,
+    const Vel& velocity,
     fp_t mass,
     uint64_t carr_num) : Carrier()
 {
     this->Set(charge, position, velocity, mass, carr_num);
-    this->setID();
-}
-
-Carrier::Carrier(const Carrier& other) : \
-    charge(other.GetCharge()),
-    position(other.GetPos()),
-    velocity(other.GetVel()),
-    force(other.GetForce()),
-    mass(other.GetMass()),
-    index(other.GetIndex()),
-    CarrID(other.GetID()),
-    CarrType(other.GetType())
-{
-}
-
-Carrier::Carrier(Carrier&& other) noexcept: \
-    charge(other.GetCharge()),
-    position(other.GetPos()),
-    velocity(other.GetVel()),
-    force(other.GetForce()),
-    mass(other.GetMass()),
-    index(other.GetIndex()),
-    CarrID(other.GetID()),
-    CarrType(other.GetType())
-{
-}
-
-Carrier::~Carrier()
-{
-    // Nothing to do now.
 }
 
 
@@ -8,6 +8,7 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <type_traits>
 
 #include "fputils.h"
 #include "Utils.h"
@@ -29,8 +30,42 @@ cfp_t rand_delta_min = 1e-6;
 cfp_t rand_delta_max = 1e-5;
 
 // Some definitions
-constexpr short CARR_T_HOLE = 1;
-constexpr short CARR_T_ELECTRON = 0;
+enum CarrierType : uint8_t {
+    CARR_T_ELECTRON = 0,
+    CARR_T_HOLE = 1
+};
+
+// Storage precision of velocity.
+// Velocity is rebuilt every kick from fp_t force, so single precision
+// is enough and keeps a carrier within 64 bytes. Force stays fp_t:
+// pair contributions are added up in it.
+// --> Compensated build adds up forces with a Kahan term.
+#if defined(__MULTIPRECISION__) || defined(__COMPENSATED__)
+using carr_sfp_t = fp_t;
+#else
+using carr_sfp_t = float;
+#endif
+using CarrVec = __tuple_3D__<carr_sfp_t>;
+
+// Running sum of pair forces, kept out of the carrier until done.
+// --> Compensated build adds up with a Kahan term.
+struct ForceSum {
+    Force sum;
+#ifdef __COMPENSATED__
+    Force c;
+#endif
+
+    void add(const Force& f)
+    {
+#ifdef __COMPENSATED__
+        fp_kahan_add<fp_t>(this->sum.x, this->c.x, f.x);
+        fp_kahan_add<fp_t>(this->sum.y, this->c.y, f.y);
+        fp_kahan_add<fp_t>(this->sum.z, this->c.z, f.z);
+#else
+        this->sum += f;
+#endif
+    }
+};
 
 /**
  * Carrier (class)
@@ -39,43 +74,74 @@ constexpr short CARR_T_ELECTRON = 0;
  * Location (X,Y,Z), velocity(VX,VY,VZ), and
  * calculates force from other carriers.
  *
+ * A plain, trivially copyable record. Charge and effective mass
+ * follow the carrier type and ID strings are only built for output.
+ *
 **/
 class Carrier
 {
 private:
-    fp_t charge;          // Charge of a carrier (C)
     Loc position;         // Position in Cartesian coordinate set (um)
-    Vel velocity;         // Velocity in Cartesian coordinate set (um/s)
-    Force force;          // Force in Cartesian coordinate set (m/s^2)
-    fp_t mass;            // Effective mass (kg)
-    uint64_t index;       // Index... just for bureaucracy stuff...
-    std::string CarrID;   // ID... another bureaucracy stuff...
-    std::string CarrType; // carrier type in string
+    Force force;          // Force in Cartesian coordinate set (N)
+    CarrVec velocity;     // Velocity in Cartesian coordinate set (um/s)
+#ifdef __COMPENSATED__
+    Loc position_c;       // Kahan terms of position (um)
+    Force force_c;        // Kahan terms of force
+#endif
+    uint32_t index : 31;  // Index... just for bureaucracy stuff...
+    uint32_t type : 1;    // CarrierType: Electron or Hole
 
 public:
-    void setType();
-    void setType(const std::string& new_type);
-    void setID();
+    // Effective mass of each carrier type (kg)
+    static fp_t type_mass[2];
+
+    // Largest index a carrier can hold
+    static const uint64_t MaxIndex = (1ULL << 31) - 1;
+
     void setMass();
 
     // Setting up parameters manually
-    void SetCharge(fp_t new_charge) { this->charge = new_charge; }
-    void SetCharge(); // Setting charge by carrier type.
+    void SetCharge(fp_t new_charge)
+    { this->type = fp_lt<fp_t>(new_charge, FP_T(0.0)) ? CARR_T_ELECTRON : CARR_T_HOLE; }
+    void SetType(const CarrierType& new_type) { this->type = new_type; }
     void SetType(std::string typestr);
-    void SetPos(Loc new_position) { this->position = new_position; }
-    void SetVel(Vel new_velocity) { this->velocity = new_velocity; }
-    void SetForce(Force new_force) { this->force = new_force; }
-    void SetMass(fp_t new_mass) { this->mass = new_mass; }
-    void SetIndex(uint64_t new_index) 
+    void SetPos(const Loc& new_position)
     {
-        this->index = new_index;
-        this->setType();
-        this->setID();
+        this->position = new_position;
+#ifdef __COMPENSATED__
+        this->position_c = Loc{ 0, 0, 0 };
+#endif
+    }
+    void SetVel(const Vel& new_velocity)
+    {
+        this->velocity = CarrVec{
+            static_cast<carr_sfp_t>(new_velocity.x),
+            static_cast<carr_sfp_t>(new_velocity.y),
+            static_cast<carr_sfp_t>(new_velocity.z) };
+    }
+    void SetForce(const Force& new_force)
+    {
+        this->force = new_force;
+#ifdef __COMPENSATED__
+        this->force_c = Force{ 0, 0, 0 };
+#endif
+    }
+    // Sets effective mass of every carrier of this type.
+    void SetMass(const fp_t& new_mass)
+    { Carrier::type_mass[this->type] = new_mass; }
+    void SetIndex(uint64_t new_index)
+    {
+        if (new_index > Carrier::MaxIndex) {
+            std::cerr << "Error!! Carrier index " << new_index \
+                << " is out of range!!" << std::endl;
+            exit(-1);
+        }
+        this->index = static_cast<uint32_t>(new_index);
     }
     void Set(
         fp_t new_charge,
-        Loc new_position,
-        Vel new_velocity,
+        const Loc& new_position,
+        const Vel& new_velocity,
         fp_t new_mass,
         uint64_t new_index)
     {
@@ -87,59 +153,90 @@ public:
     }
     void Set(
         std::string carr_type,
-        Loc new_position,
-        Vel new_velocity,
+        const Loc& new_position,
+        const Vel& new_velocity,
         fp_t new_mass,
         uint64_t new_index)
     {
         this->SetType(carr_type);
-        this->position = new_position;
-        this->velocity = new_velocity;
-        this->mass = new_mass;
-        this->index = new_index;
-
-        this->setType();
-        this->setID();
+        this->SetPos(new_position);
+        this->SetVel(new_velocity);
+        this->SetMass(new_mass);
+        this->SetIndex(new_index);
     }
 
     void ResetVelnForce()
     {
-        this->velocity = ZeroVel;
-        this->force = ZeroForce;
+        this->velocity = CarrVec{ 0, 0, 0 };
+        this->force = Force{ 0, 0, 0 };
+#ifdef __COMPENSATED__
+        this->force_c = Force{ 0, 0, 0 };
+#endif
     }
 
     // Retrieve properties
-    fp_t GetCharge() const { return this->charge; }
+    fp_t GetCharge() const
+    { return (this->type == CARR_T_ELECTRON) ? q_e : q_h; }
     Loc GetPos() const { return this->position; }
     std::string GetPosStr() const;
-    Vel GetVel() const { return this->velocity; }
+    Vel GetVel() const
+    { return Vel{ this->velocity.x, this->velocity.y, this->velocity.z }; }
     std::string GetVelStr() const;
     Force GetForce() const { return this->force; }
     std::string GetForceStr() const;
-    fp_t GetMass() const { return this->mass; }
+    fp_t GetMass() const { return Carrier::type_mass[this->type]; }
     uint64_t GetIndex() const { return this->index; }
-    std::string GetID() const { return this->CarrID; }
-    std::string GetType() const { return this->CarrType; }
-    short GetTypeI();
+    // Formatted on demand: output paths only.
+    std::string GetID() const;
+    std::string GetType() const
+    { return (this->type == CARR_T_ELECTRON) ? "Electron" : "Hole"; }
+    CarrierType GetTypeI() const
+    { return static_cast<CarrierType>(this->type); }
 
     // Add Force
     void AddForce(const Force& ext_force)
-    { this->force += ext_force; }
+    {
+#ifdef __COMPENSATED__
+        fp_kahan_add<fp_t>(this->force.x, this->force_c.x, ext_force.x);
+        fp_kahan_add<fp_t>(this->force.y, this->force_c.y, ext_force.y);
+        fp_kahan_add<fp_t>(this->force.z, this->force_c.z, ext_force.z);
+#else
+        this->force += ext_force;
+#endif
+    }
 
     // Update velocity
     void UpdateVel(const fp_t& time_delta)
-    { this->velocity += (this->force/this->mass)*time_delta; }
+    {
+        auto dv = time_delta/this->GetMass();
+        this->velocity.x += static_cast<carr_sfp_t>(this->force.x*dv);
+        this->velocity.y += static_cast<carr_sfp_t>(this->force.y*dv);
+        this->velocity.z += static_cast<carr_sfp_t>(this->force.z*dv);
+    }
     // with modifier: Remember that Force is stored as MKS all the time.
     void UpdateVel(const fp_t& time_delta, const fp_t& modifier)
     { this->UpdateVel(time_delta*modifier); }
 
     // Update location with time (must be sec. unit...)
     void UpdatePos(const fp_t& time_delta)
-    { this->position += (this->velocity * time_delta); }
+    {
+        this->AdjPosDelta(Loc{
+            this->velocity.x*time_delta,
+            this->velocity.y*time_delta,
+            this->velocity.z*time_delta });
+    }
 
     // Position adjustment
-    void AdjPosDelta(Loc DeltaPos)
-    { this->position += DeltaPos; }
+    void AdjPosDelta(const Loc& DeltaPos)
+    {
+#ifdef __COMPENSATED__
+        fp_kahan_add<fp_t>(this->position.x, this->position_c.x, DeltaPos.x);
+        fp_kahan_add<fp_t>(this->position.y, this->position_c.y, DeltaPos.y);
+        fp_kahan_add<fp_t>(this->position.z, this->position_c.z, DeltaPos.z);
+#else
+        this->position += DeltaPos;
+#endif
+    }
 
     // Some operator overloading stuff
     bool operator==(const Carrier& other_carrier) const
@@ -147,59 +244,30 @@ public:
     bool operator!=(const Carrier& other_carrier) const
     { return (this->index != other_carrier.GetIndex()); }
 
-    // Copy assignment operators
-    Carrier& operator= (const Carrier& other)
-    {
-        Carrier tmp(other);
-        *this = std::move(tmp);
-        return *this;
-    }
-    Carrier& operator= (Carrier&& other) noexcept
-    {
-        this->Set(
-            other.GetCharge(),
-            other.GetPos(),
-            other.GetVel(),
-            other.GetMass(),
-            other.GetIndex());
-        this->setID();
-
-        return *this;
-    }
-
-    // Some operators for BHTree insertion
-    Carrier& operator+ (Carrier Other)
-    {
-        if (Other != *this) {
-            this->charge += Other.GetCharge();
-            this->position = (this->position + Other.GetPos())/2.0;
-            this->velocity += Other.GetVel();
-            this->force += Other.GetForce();
-            this->mass += Other.GetMass();
-            // Just leave index system for now...
-        }
-        return *this;
-    }
-
-    // Constructors and Destructors
+    // Constructors: copy and move are the implicit (trivial) ones.
     Carrier();
     Carrier(
         std::string carrier_type,
-        Loc position,
-        Vel velocity,
+        const Loc& position,
+        const Vel& velocity,
         fp_t mass,
         uint64_t carr_num);
     Carrier(
         fp_t charge,
-        Loc position,
-        Vel velocity,
+        const Loc& position,
+        const Vel& velocity,
         fp_t mass,
         uint64_t carr_num);
-    Carrier(const Carrier& other);
-    Carrier(Carrier&& other) noexcept;
-    virtual ~Carrier();
 };
 
+#ifndef __MULTIPRECISION__
+static_assert(std::is_trivially_copyable<Carrier>::value,
+    "Carrier must stay trivially copyable!!");
+#ifndef __COMPENSATED__
+static_assert(sizeof(Carrier) == 64,
+    "Carrier must fit in 64 bytes!!");
+#endif
+#endif
 
 // Integrating with ostream
 std::ostream& operator<< (std::ostream& os, const Carrier& carrier);
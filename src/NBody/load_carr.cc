@@ -58,6 +58,10 @@ int LoadCarrDB::read_database()
         exit(-1);
     }
 
+    // Single time indexed table: one indexed query does the job.
+    if (this->is_single_table_db())
+        return this->read_database_ts(std::string());
+
     // Ok let's list tables and select a newest elapsed time.
     sqlcmd = "SELECT * FROM SQLITE_MASTER WHERE type='table'";
     // Now populate table list
@@ -71,15 +75,11 @@ int LoadCarrDB::read_database()
     // Then find out a proper newest data.
     elapsed_time = this->select_latest_data();
 
-    // Preparing SQLite command
-    sqlcmd = "SELECT * from '"+elapsed_time+"'";
-
     // Now read in table of given elapsed time.
-    rc = sqlite3_exec(
-        this->CarrierDB,
-        sqlcmd.c_str(),
-        loadcarrdb_callback,
-        this, &zErrMsg);
+    this->read_frame(
+        "SELECT COUNT(*) FROM '"+elapsed_time+"'",
+        "SELECT CARR_INDEX, TYPE, MASS, X, Y, Z, VX, VY, VZ, FX, FY, FZ " \
+        "FROM '"+elapsed_time+"'");
 
     // Close up DB
     sqlite3_close(this->CarrierDB);
@@ -99,29 +99,24 @@ int LoadCarrDB::read_database()
 // Reads certain table at specific time.
 int LoadCarrDB::read_database(std::string elapsed_time)
 {
-    char*        zErrMsg = nullptr;
-    int          rc;
-    const char*  data = "Callback function ended!!";
-
-    // SQL command storage
-    std::string  sqlcmd;
-
     // Opening the Carrier database.
-    rc = sqlite3_open(this->db_fname.c_str(), &this->CarrierDB);
+    int rc = sqlite3_open(this->db_fname.c_str(), &this->CarrierDB);
     if (rc != SQLITE_OK) {
         std::cerr \
-            << zErrMsg << "] Carrier read in failure!!" \
+            << sqlite3_errmsg(this->CarrierDB) << "] Carrier read in failure!!" \
             << std::endl;
         exit(-1);
     }
 
-    // Preparing SQLite command
-    sqlcmd = "SELECT * from '"+elapsed_time+"'";
+    // Single time indexed table: elapsed_time is the frame label.
+    if (this->is_single_table_db())
+        return this->read_database_ts(elapsed_time);
 
     // Now read in table of given elapsed time.
-    rc = sqlite3_exec(
-        this->CarrierDB, sqlcmd.c_str(), loadcarrdb_callback,
-        this, &zErrMsg);
+    this->read_frame(
+        "SELECT COUNT(*) FROM '"+elapsed_time+"'",
+        "SELECT CARR_INDEX, TYPE, MASS, X, Y, Z, VX, VY, VZ, FX, FY, FZ " \
+        "FROM '"+elapsed_time+"'");
 
     // Close up DB
     sqlite3_close(this->CarrierDB);
@@ -136,6 +131,165 @@ int LoadCarrDB::read_database(std::string elapsed_time)
     return 0;
 }
 
+// Checks if the database uses single time indexed table.
+bool LoadCarrDB::is_single_table_db()
+{
+    sqlite3_stmt* stmt = nullptr;
+    bool found = false;
+
+    int rc = sqlite3_prepare_v2(
+        this->CarrierDB,
+        "SELECT name FROM sqlite_master WHERE type='table' AND name='steps'",
+        -1, &stmt, 0);
+    if (rc == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        found = true;
+    sqlite3_finalize(stmt);
+
+    return found;
+}
+
+// Reads a frame from single time indexed table.
+// (CarrierDB must be opened already, closes it at the end.)
+int LoadCarrDB::read_database_ts(const std::string& label)
+{
+    sqlite3_stmt* stmt = nullptr;
+    int           rc;
+
+    // Find the frame: steps is keyed by STEP, so this is one lookup.
+    if (label.empty()) {
+        rc = sqlite3_prepare_v2(
+            this->CarrierDB,
+            "SELECT STEP, TIME, LABEL FROM steps WHERE N_CARRIERS > 0 " \
+            "ORDER BY STEP DESC LIMIT 1",
+            -1, &stmt, 0);
+    }
+    else {
+        rc = sqlite3_prepare_v2(
+            this->CarrierDB,
+            "SELECT STEP, TIME, LABEL FROM steps WHERE LABEL = ?1 " \
+            "ORDER BY STEP DESC LIMIT 1",
+            -1, &stmt, 0);
+        if (rc == SQLITE_OK)
+            sqlite3_bind_text(stmt, 1, label.c_str(), -1, SQLITE_TRANSIENT);
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr \
+            << "read_database_ts: SQLite Prepare V2 error!!" \
+            << std::endl;
+        exit(-1);
+    }
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr \
+            << "LoadCarrDB: no carrier frame found!!" << std::endl;
+        exit(-1);
+    }
+
+    auto step = sqlite3_column_int64(stmt, 0);
+    this->sim_time = static_cast<fp_t>(sqlite3_column_double(stmt, 1));
+    std::string frame_label(
+        reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
+    sqlite3_finalize(stmt);
+
+    std::cout << "Selecting frame: " << frame_label \
+        << " (step " << step << ")" << std::endl;
+
+    // Read in the frame: (STEP, IDX) is the primary key.
+    std::stringstream where;
+    where << "FROM carriers WHERE STEP = " << step;
+    this->read_frame(
+        "SELECT COUNT(*) " + where.str(),
+        "SELECT IDX, TYPE, MASS, X, Y, Z, VX, VY, VZ, FX, FY, FZ " + where.str());
+
+    // Close up DB
+    sqlite3_close(this->CarrierDB);
+    std::cout \
+        << "Carrier readout from timestamp " \
+        << frame_label << " ps has been completed!!" \
+        << std::endl;
+
+    return 0;
+}
+
+// Streams a frame into dbCarriers.
+//
+// Rows are read with a prepared statement and typed column access.
+// All carriers of the frame share one contiguous block: each
+// spCarrier aliases its record in the block, so there is one
+// allocation per frame instead of one per carrier.
+//
+int LoadCarrDB::read_frame(
+    const std::string& count_sql, const std::string& select_sql)
+{
+    sqlite3_stmt* stmt = nullptr;
+    uint64_t n_rows = 0;
+
+    // Count first: storage is allocated once.
+    if (sqlite3_prepare_v2(this->CarrierDB, count_sql.c_str(), -1, &stmt, 0) == SQLITE_OK && \
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        n_rows = static_cast<uint64_t>(sqlite3_column_int64(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+
+    auto block = std::make_shared<std::vector<Carrier>>(n_rows);
+    this->dbCarriers.clear();
+    this->dbCarriers.reserve(n_rows);
+    this->num_elec_read = 0;
+    this->num_hole_read = 0;
+
+    if (sqlite3_prepare_v2(this->CarrierDB, select_sql.c_str(), -1, &stmt, 0) != SQLITE_OK) {
+        std::cerr \
+            << "read_frame: SQLite Prepare V2 error: " \
+            << sqlite3_errmsg(this->CarrierDB) << std::endl;
+        exit(-1);
+    }
+
+    auto column_fp = [&stmt](const int& col) {
+        return static_cast<fp_t>(sqlite3_column_double(stmt, col));
+    };
+
+    uint64_t i = 0;
+    while (i < n_rows && sqlite3_step(stmt) == SQLITE_ROW) {
+        auto& carrier = (*block)[i];
+
+        carrier.SetIndex(static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)));
+
+        // TYPE: integer (single table) or text (table per step)
+        if (sqlite3_column_type(stmt, 1) == SQLITE_INTEGER) {
+            carrier.SetType(
+                sqlite3_column_int(stmt, 1) == CARR_T_ELECTRON ? \
+                CARR_T_ELECTRON : CARR_T_HOLE);
+        }
+        else {
+            auto type_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            carrier.SetType(
+                (type_str && (type_str[0] == 'E' || type_str[0] == 'e')) ? \
+                CARR_T_ELECTRON : CARR_T_HOLE);
+        }
+
+        if (carrier.GetTypeI() == CARR_T_ELECTRON) {
+            this->num_elec_read++;
+            carrier.SetMass(this->read_electron_mass > FP_T_ZERO ? \
+                this->read_electron_mass : column_fp(2));
+        }
+        else {
+            this->num_hole_read++;
+            carrier.SetMass(this->read_hole_mass > FP_T_ZERO ? \
+                this->read_hole_mass : column_fp(2));
+        }
+
+        carrier.SetPos(Loc{ column_fp(3), column_fp(4), column_fp(5) });
+        carrier.SetVel(Vel{ column_fp(6), column_fp(7), column_fp(8) });
+        carrier.SetForce(Force{ column_fp(9), column_fp(10), column_fp(11) });
+
+        this->dbCarriers.emplace_back(block, &carrier);
+        ++i;
+    }
+    sqlite3_finalize(stmt);
+
+    return 0;
+}
+
 // Helps read_database() to select the proper table.
 std::string LoadCarrDB::select_latest_data()
 {
@@ -258,148 +412,6 @@ std::string LoadCarrDB::select_latest_data()
 // Sqlite3 callbacks
 //
 
-// Reads in Carriers
-int LoadCarrDB::Callback(int argc, char** argv, char** azColName)
-{
-    this->temp_carrier = nullptr;
-    std::string colname = {};
-
-    uint64_t index;
-    std::string carr_type;
-    fp_t carr_mass;
-    fp_t X, Y, Z;
-    fp_t VX, VY, VZ;
-    fp_t FX, FY, FZ;
-
-    Loc tempLoc = Loc{};
-    Vel tempVel = Vel{};
-    Force tempForce = Force{};
-
-    // Read in current table
-    for (auto i=0; i<argc; ++i) {
-        if (argv[i]) {
-            // Initialize a carrier
-            colname = azColName[i];
-            // Ok, let's parse columns.
-            if (colname == "CARR_INDEX") {
-                try {
-                    index = boost::lexical_cast<uint64_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    index = 0;
-                }
-            }
-            else if (colname == "TYPE") {
-                carr_type = std::string(argv[i]);
-            }
-            else if (colname == "MASS") {
-                try {
-                    carr_mass = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch (const boost::bad_lexical_cast&) {
-                    carr_mass = FP_T_ZERO;
-                }
-            }
-            else if (colname == "X") {
-                try {
-                    X = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    X = FP_T_ZERO;
-                }
-            }
-            else if (colname == "Y") {
-                try {
-                    Y = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    Y = FP_T_ZERO;
-                }
-            }
-            else if (colname == "Z") {
-                try {
-                    Z = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    Z = FP_T_ZERO;
-                }
-            }
-            else if (colname == "VX") {
-                try {
-                    VX = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    VX = FP_T_ZERO;
-                }
-            }
-            else if (colname == "VY") {
-                try {
-                    VY = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    VY = FP_T_ZERO;
-                }
-            }
-            else if (colname == "VZ") {
-                try {
-                    VZ = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    VZ = FP_T_ZERO;
-                }
-            }
-            else if (colname == "FX") {
-                try {
-                    FX = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    FX = FP_T_ZERO;
-                }
-            }
-            else if (colname == "FY") {
-                try {
-                    FY = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    FY = FP_T_ZERO;
-                }
-            }
-            else if (colname == "FZ") {
-                try {
-                    FZ = boost::lexical_cast<fp_t>(argv[i]);
-                }
-                catch(const boost::bad_lexical_cast&) {
-                    FZ = FP_T_ZERO;
-                }
-            }
-        } /* if (argv[i]) */
-    } /* for (auto i=0; i<argc; i++) */
-
-    tempLoc = {X, Y, Z};
-    tempVel = {VX, VY, VZ};
-    tempForce = {FX, FY, FZ};
-
-    // Ok, ready the temporary carrier.
-    this->temp_carrier = std::make_shared<Carrier>();
-    // this->temp_carrier->Set(
-    // 	carr_type, tempLoc, tempVel, tempForce);
-    this->temp_carrier->SetType(carr_type);
-    this->temp_carrier->SetPos(tempLoc);
-    this->temp_carrier->SetVel(tempVel);
-    this->temp_carrier->SetForce(tempForce);
-    this->temp_carrier->SetIndex(index);
-
-    // Setting up mass... but we need to reconsider where to set up
-    // mass, anyway...
-    this->temp_carrier->SetMass(carr_mass);
-    this->temp_carrier->setID();
-
-    // then push it into container.
-    this->dbCarriers[index] = this->temp_carrier;
-
-    return 0;
-}
-
 // Extracts Table list from database.
 int LoadCarrDB::TableListCallback(int argc, char** argv, char** azColName)
 {
@@ -444,7 +456,7 @@ CarrierList LoadCarrDB::GetCarriers(std::string input_db_fname)
 {
     this->db_fname = input_db_fname;
     this->read_database();
-    return this->dbCarriers;
+    return std::move(this->dbCarriers);
 }
 
 // Reads in database with given time slot and returns the carriers
@@ -452,7 +464,7 @@ CarrierList LoadCarrDB::GetCarriers(std::string input_db_fname, std::string elap
 {
     this->db_fname = input_db_fname;
     this->read_database(elapsed_time);
-    return this->dbCarriers;
+    return std::move(this->dbCarriers);
 }
 
 
@@ -471,9 +483,12 @@ CarrierList LoadCarrDB::GetCarriers(std::string input_db_fname, std::string elap
 LoadCarrDB::LoadCarrDB() :
     num_of_carriers(0),
     db_fname(std::string()),
-    temp_carrier(nullptr),
     tbl_list({}),
     CarrierDB(nullptr),
+    read_electron_mass(FP_T(0.0)),
+    read_hole_mass(FP_T(0.0)),
+    num_elec_read(0),
+    num_hole_read(0),
     sim_time(FP_T(0.0))
 {
 }
@@ -513,13 +528,6 @@ LoadCarrDB::~LoadCarrDB()
  * --> Redirects callbacks to LoadCarrDB class via void pointer.
  *
 **/
-static int loadcarrdb_callback(
-    void* param, int argc, char** argv, char** azColName)
-{
-    LoadCarrDB* loadcarrdb = reinterpret_cast<LoadCarrDB*>(param);
-    return loadcarrdb->Callback(argc, argv, azColName);
-}
-
 static int loadcarrdb_tablelist_callback(
     void* param, int argc, char** argv, char** azColName)
 {
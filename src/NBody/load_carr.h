@@ -42,7 +42,6 @@ private:
 	// Some management stuff.
 	uint64_t num_of_carriers;
 	std::string db_fname;
-	spCarrier temp_carrier;
 	std::vector<std::string> tbl_list;
 
 	// Actuallyl reads in database
@@ -52,15 +51,44 @@ private:
 	// Selects a proper table and returns its name.
 	std::string select_latest_data();
 
+	// Single time indexed table (carriers + steps) support.
+	// --> label empty: picks the latest non-empty frame.
+	bool is_single_table_db();
+	int read_database_ts(const std::string& label);
+
+	// Streams a frame into dbCarriers with prepared statements.
+	// select_sql must return IDX, TYPE, MASS, X, Y, Z, VX, VY, VZ,
+	// FX, FY, FZ in this order. count_sql returns the number of rows.
+	int read_frame(
+		const std::string& count_sql, const std::string& select_sql);
+
+	// Masses given by type while reading (0: use MASS column)
+	fp_t read_electron_mass;
+	fp_t read_hole_mass;
+
+	// Electrons and holes in the last frame read
+	uint64_t num_elec_read;
+	uint64_t num_hole_read;
+
 protected:
 	fp_t sim_time;
 
 public:
 	// Sqlite3 read in stuffs.
-	int Callback(int argc, char** argv, char** azColName);
 	int TableListCallback(int argc, char** argv, char** azColName);
 	int ChkTableCallback(int argc, char** argv, char** azColName);
 
+	// Set up masses assigned while reading carriers.
+	void SetReadMass(const fp_t& electron_mass, const fp_t& hole_mass)
+	{
+		this->read_electron_mass = electron_mass;
+		this->read_hole_mass = hole_mass;
+	}
+
+	// Electrons and holes in the last frame read
+	uint64_t GetNumElecRead() const { return this->num_elec_read; }
+	uint64_t GetNumHoleRead() const { return this->num_hole_read; }
+
 	// Returns current Carriers we have.
 	CarrierList GetCarriers();
 	CarrierList GetCarriers(
@@ -78,8 +106,6 @@ public:
 
 
 // Sqlite3 callback function --> redirects into LoadCarrDB
-static int loadcarrdb_callback(
-	void* param, int argc, char** argv, char** azColName);
 static int loadcarrdb_tablelist_callback(
 	void* param, int argc, char** argv, char** azColName);
 static int loadcarrdb_chk_table_callback(
@@ -38,8 +38,8 @@ void NBody::update_force(spCarrier& carrier, const fp_t& tau)
     auto end = std::end(this->Carriers);
 
     for (it; it != end; ++it) {
-        if (it->second != carrier)
-            seg_coulomb_force += this->CoulombForce(carrier, it->second);
+        if (*it != carrier)
+            seg_coulomb_force += this->CoulombForce(carrier, *it);
     }
 
     // Update total Force..
@@ -75,14 +75,18 @@ void NBody::update_all_force_sub(
     std::advance(it, istart);
     std::advance(end, istart + ipoints);
 
+    auto& counters = this->prof_thread();
+    auto prof_start = this->prof_clock();
     for (it; it != end; ++it) {
-        this->update_force(it->second, tau);
+        this->update_force(*it, tau);
+        counters.pairs += this->Carriers.size() - 1;
 
 #pragma omp critical
     {
         this->ForceCal.Update();
     }
     } /* for (it; it!=end; it++) */
+    this->prof_work(counters, PROF_FORCE, prof_start);
 
     return;
 }
@@ -96,7 +100,9 @@ void NBody::update_all_force(const fp_t& tau)
 #ifdef _OPENMP
     uint64_t ithread, nthreads, ipoints, istart, npoints;
     fp_t openmp_tau = tau;
-#pragma omp parallel private(ithread, nthreads, ipoints, istart, npoints)
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_KICK, this->Carriers.size());
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ithread, nthreads, ipoints, istart, npoints)
     {
         npoints = this->Carriers.size();
         ithread = omp_get_thread_num();
@@ -110,7 +116,8 @@ void NBody::update_all_force(const fp_t& tau)
 #pragma omp barrier
 #else /* #ifdef _OPENMP */
     for (auto carr : this->Carriers) {
-        this->update_force(carr.second, tau);
+        this->update_force(carr, tau);
+        this->prof_thread().pairs += this->Carriers.size() - 1;
         this->ForceCal.Update();
     } /* for (auto carr : this->Carriers) */
       //std::cout << std::endl;
@@ -125,7 +132,7 @@ void NBody::update_all_force(const fp_t& tau)
 /**********************************************************/
 // Update carrier position
 //
-void NBody::update_carr_position(spCarrier& carrier)
+int NBody::update_carr_position(spCarrier& carrier)
 {
     // Implemented Debye length to solve the "too close carriers"
     // problem.
@@ -167,10 +174,7 @@ void NBody::update_carr_position(spCarrier& carrier)
             << ", " << carrier->GetPos().z \
             << ")" << std::endl;
         this->write_lost_carrier_info(carrier);
-        this->lost_carriers++;
-        this->add_to_rem(carrier);
-
-        return;
+        return CARR_LOST;
     }
 
     // Determine if the carrier is within the device or not.
@@ -180,17 +184,16 @@ void NBody::update_carr_position(spCarrier& carrier)
         //
         if ( this->is_collectable(carrier, prev_pos) ) {
             this->write_collected_carrier_info(carrier);
-            this->collected_carriers++;
-            this->add_to_rem(carrier);
+            return CARR_COLLECTED;
         }
-
-        return;
+        return CARR_STAY;
     }
 
+    return CARR_STAY;
 }
 
 // Same with update_carr_position but with given time.
-void NBody::update_carr_position(spCarrier& carrier, const fp_t& tau)
+int NBody::update_carr_position(spCarrier& carrier, const fp_t& tau)
 {
     // Implemented Debye length to solve the "too close carriers"
     // problem.
@@ -199,7 +202,9 @@ void NBody::update_carr_position(spCarrier& carrier, const fp_t& tau)
     Loc prev_pos = carrier->GetPos();
     carrier->UpdatePos(tau);
     // Update positions with mean free path estimation.
+    auto mfp_start = this->prof_clock();
     this->MFPAdj(carrier, tau);
+    this->prof_add_mfp(mfp_start);
     // Apply diffusion
     this->Diffusion(carrier, tau);
     // New position...
@@ -234,10 +239,7 @@ void NBody::update_carr_position(spCarrier& carrier, const fp_t& tau)
             << ", " << carrier->GetPos().z \
             << ")" << std::endl;
         this->write_lost_carrier_info(carrier);
-        this->lost_carriers++;
-        this->add_to_rem(carrier);
-
-        return;
+        return CARR_LOST;
     }
 
     // Determine if the carrier is within the device or not.
@@ -247,33 +249,42 @@ void NBody::update_carr_position(spCarrier& carrier, const fp_t& tau)
         //
         if (this->is_collectable(carrier, prev_pos)) {
             this->write_collected_carrier_info(carrier);
-            this->collected_carriers++;
-            this->add_to_rem(carrier);
+            return CARR_COLLECTED;
         }
-        return;
+        return CARR_STAY;
     }
+
+    return CARR_STAY;
 }
 
 // Segmentation of update_all_carr_position (OpenMP)
 // --> timed version
 //
 void NBody::update_all_carr_position_sub(
-    uint64_t& istart, uint64_t& ipoints, const fp_t& tau)
+    uint64_t& istart, uint64_t& ipoints, const fp_t& tau,
+    uint64_t& n_collected, uint64_t& n_lost,
+    StatsPartial& partial)
 {
-    auto it = std::begin(this->Carriers);
-    std::advance(it, istart);
-    auto end = std::begin(this->Carriers);
-    std::advance(end, istart + ipoints);
-
-    for (it; it != end; ++it) {
-        this->update_carr_position(it->second, tau);
-
-#pragma omp critical
-        {
-            this->LocCal.Update();
-        }
-
-    } /* for (it; it != end; ++it) */
+    bool stats_on = this->IsStatsOn();
+    auto& counters = this->prof_thread();
+    auto prof_start = this->prof_clock();
+    for (auto i = istart; i < istart + ipoints; ++i) {
+        fp_t t_collect = FP_T(-1.0);
+        auto carr_status = \
+            this->FastForward(this->Carriers[i], t_collect) ? \
+            CARR_COLLECTED : \
+            this->update_carr_position(this->Carriers[i], tau);
+        if (stats_on)
+            this->stats_add(
+                partial, *this->Carriers[i], carr_status, t_collect);
+        if (carr_status == CARR_STAY) continue;
+
+        if (carr_status == CARR_COLLECTED) n_collected++;
+        else n_lost++;
+        ++counters.removed;
+        this->add_to_rem(i);
+    } /* for (auto i = istart; i < istart + ipoints; ++i) */
+    this->prof_work(counters, PROF_DRIFT, prof_start);
 
     return;
 }
@@ -283,18 +294,25 @@ void NBody::update_all_carr_position_sub(
 //
 void NBody::update_all_carr_position(const fp_t& tau)
 {
+    this->prof_begin(PROF_DRIFT);
     this->LocCal = ProgressBar(
         "Loc Update.", this->Carriers.size());
 
-    //this->CarriersToRemove = CarrierList();
-    if (this->CarriersToRemove.size()) {
-        this->CarriersToRemove.clear();
-    }
+    this->init_rem();
+    std::vector<uint64_t> n_collected(this->CarriersToRemove.size(), 0);
+    std::vector<uint64_t> n_lost(this->CarriersToRemove.size(), 0);
+    this->init_stats_partials(this->CarriersToRemove.size());
+    this->init_event_log();
+    this->BeginFastForward(tau);
+    this->NextRngPass();
 
 #ifdef _OPENMP
     uint64_t ith, nth, ipoints, istart, npoints;
 
-#pragma omp parallel private(ith, nth, ipoints, istart, npoints)
+    {
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_DRIFT, this->Carriers.size());
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ith, nth, ipoints, istart, npoints)
     {
         npoints = this->Carriers.size();
         ith = omp_get_thread_num();
@@ -302,25 +320,33 @@ void NBody::update_all_carr_position(const fp_t& tau)
         ipoints = npoints / nth;
         istart = ith * ipoints;
         if (ith == nth - 1) ipoints = npoints - istart;
-        this->update_all_carr_position_sub(istart, ipoints, tau);
+        this->update_all_carr_position_sub(
+            istart, ipoints, tau, n_collected[ith], n_lost[ith],
+            this->stats_partials[ith]);
     }  /* #pragma omp parallel */
+    }
 
 #else
+    uint64_t istart = 0, ipoints = this->Carriers.size();
+    this->update_all_carr_position_sub(
+        istart, ipoints, tau, n_collected[0], n_lost[0],
+        this->stats_partials[0]);
+#endif
 
-    auto it = std::begin(this->Carriers);
-    while (true) {
-        this->update_carr_position(it->second, tau);
-        this->LocCal.Update();
-        if (it != std::end(this->Carriers)) ++it;
-        else break;
-    }
+    this->LocCal.Update(this->Carriers.size());
 
-#endif
+    for (auto cnt : n_collected) this->collected_carriers += cnt;
+    for (auto cnt : n_lost) this->lost_carriers += cnt;
+
+    // Merge streaming statistics of this drift.
+    this->MergeStats(tau);
+
+    this->prof_end(PROF_DRIFT);
 
     // Remove marked carriers.
-    for (auto ctr : this->CarriersToRemove) {
-        this->remove_carr(ctr);
-    }
+    this->prof_begin(PROF_REMOVE);
+    this->remove_marked_carr();
+    this->prof_end(PROF_REMOVE);
     return;
 }
 
@@ -374,6 +400,18 @@ int NBody::InitSim()
     omp_set_num_threads(this->processes);
 #endif
 
+    // Preparing event log buffers.
+    this->init_event_log();
+
+    // Restarting from a checkpoint: carriers and progress come
+    // from the checkpoint file.
+    if (this->IsRestart()) {
+        this->LoadCheckpoint(this->restart_file);
+        // Saved velocities are from before the last drift: kick again.
+        this->pass_forcecal = false;
+        return 0;
+    }
+
     // Read in data and generate carrier list.
     // tarball input case
     if (!this->continued) {
@@ -426,6 +464,7 @@ void NBody::Select(const fp_t& tau)
 //
 int NBody::Drift(const fp_t& tau)
 {
+    this->AccumulateSignal(tau);
     this->update_all_carr_position(tau);
 
     return 0;
@@ -439,6 +478,13 @@ int NBody::Drift(const fp_t& tau)
 //
 int NBody::Kick(const fp_t& tau)
 {
+    return this->KickEngine(this->StepForceEngine(), tau);
+}
+
+// Kick with direct sum
+int NBody::KickNative(const fp_t& tau)
+{
+    ProfScope prof(this, PROF_FORCE);
     this->update_all_force(tau);
 
     return 0;
@@ -466,11 +512,19 @@ int NBody::Run()
 
     // Now actually runs the simulation
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Setting up delta_t
         if (!this->forced_delta_t) this->Select();
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -487,13 +541,34 @@ int NBody::Run()
         this->Drift(this->delta_t);
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
 
     // Wrapping up.
@@ -515,12 +590,20 @@ int NBody::RunSDKD()
     this->InitSim();
 
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Select
         if (!this->forced_delta_t) this->Select();
         // else this->Select(this->delta_t);
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -537,13 +620,34 @@ int NBody::RunSDKD()
         this->Drift(this->delta_t / 2.0);
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
     // Wrapping up.
     this->SimFinishMessage();
@@ -565,12 +669,20 @@ int NBody::RunSKDK()
     this->InitSim();
 
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Select
         if (!this->forced_delta_t) this->Select();
         // else this->Select(this->delta_t);
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -589,13 +701,34 @@ int NBody::RunSKDK()
         this->Kick(this->delta_t / 2.0);
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
     // Wrapping up.
     this->SimFinishMessage();
@@ -37,6 +37,13 @@
 #include "CTCForce.h"
 #include "recombination_nbody.h"
 #include "sim_file_io.h"
+#include "sim_checkpoint.h"
+#include "sim_signal.h"
+#include "sim_stats.h"
+#include "sim_profile.h"
+#include "sim_force_engine.h"
+#include "sim_fast_forward.h"
+#include "sim_reorder.h"
 
 using namespace boost::math::constants;
 
@@ -54,6 +61,13 @@ class NBody : \
     public virtual Physics::CTCForce, \
     public virtual Physics::Recombination_NBody, \
     public virtual NBodyFileIO, \
+    public virtual NBodyCheckpoint, \
+    public virtual NBodySignal, \
+    public virtual NBodyStats, \
+    public virtual NBodyProfile, \
+    public virtual NBodyForceEngine, \
+    public virtual NBodyFastForward, \
+    public virtual NBodyReorder, \
     public virtual NBodyVisual
 {
 
@@ -68,11 +82,14 @@ protected:
     void update_all_force(const fp_t& tau);
 
     // Update carrier position
-    void update_carr_position(spCarrier& carrier);
-    void update_carr_position(spCarrier& carrier, const fp_t& tau);
+    // --> Returns CARR_STAY, CARR_COLLECTED or CARR_LOST
+    int update_carr_position(spCarrier& carrier);
+    int update_carr_position(spCarrier& carrier, const fp_t& tau);
     // Update position of all carriers
     void update_all_carr_position_sub(
-        uint64_t& istart, uint64_t& iprop, const fp_t& tau);
+        uint64_t& istart, uint64_t& ipoints, const fp_t& tau,
+        uint64_t& n_collected, uint64_t& n_lost,
+        StatsPartial& partial);
     void update_all_carr_position(const fp_t& tau);
 
     // Visualization class
@@ -103,6 +120,21 @@ protected:
     // Kick Algorithm
     int Kick(const fp_t& tau);
 
+    // Force engine: direct sum is our own.
+    unsigned int NativeForceEngine() const
+    { return FENG_DIRECT; }
+    int KickNative(const fp_t& tau);
+
+    // Checkpoint: cost model carries over to the restart.
+    void SaveRunnerState(CheckpointHeader& header) const
+    { this->SaveEngineState(header); }
+    void LoadRunnerState(const CheckpointHeader& header)
+    { this->LoadEngineState(header); }
+
+    // Fast forward: our drift diffuses.
+    bool DriftDiffuses() const
+    { return true; }
+
 public:
     // Run the actual simulation
     int Run(); // Very simple and stupid algorithm
@@ -31,14 +31,13 @@ int NBody_Octree::MakeTree()
         exit(0);
     }
 
-    // Initialize Tree
-    //this->Tree.reset();
-    this->Tree = nullptr;
-    this->Tree = std::make_shared<BHTree>(FirstOctant);
+    ProfScope prof(this, PROF_MAKETREE);
+
+    // Initialize Tree: recycles last step's nodes, root fits the cloud.
+    *this->FirstOctant = CloudOctant(this->Carriers);
+    this->TreeArena.Reset();
+    this->Tree = this->TreeArena.NewNode(*this->FirstOctant);
 
-    // Looks stupid but std::map doesn't have random access
-    // iterators. So, we can't rely on them.
-    //
     // Initializing progress bar
     uint64_t total_carriers = this->Carriers.size();
     std::string TreeTitle = std::string("Tree@")+this->to_str(this->elapsed_time);
@@ -48,7 +47,7 @@ int NBody_Octree::MakeTree()
     auto end = std::end(this->Carriers);
 
     for (it; it != end; ++it) {
-        if (!this->InsertToTree(it->second))
+        if (!this->InsertToTree(*it))
             TreeGen.Update();
     }
 
@@ -117,6 +116,11 @@ int NBody_Octree::SimInit()
         this->pass_forcecal = true;
     } /* if (this->container_file) */
 
+    if (this->simulation_logfile.is_open()) {
+        this->simulation_logfile << ss_preamble.str();
+        this->simulation_logfile.close();
+    }
+
     // Preparing visual report tool.
     this->SetOutputMode(this->log_carrier_data_format);
 
@@ -129,6 +133,18 @@ int NBody_Octree::SimInit()
     omp_set_num_threads(this->processes);
 #endif
 
+    // Preparing event log buffers.
+    this->init_event_log();
+
+    // Restarting from a checkpoint: carriers and progress come
+    // from the checkpoint file.
+    if (this->IsRestart()) {
+        this->LoadCheckpoint(this->restart_file);
+        // Saved velocities are from before the last drift: kick again.
+        this->pass_forcecal = false;
+        return 0;
+    }
+
     // Read in data and generate carrier list.
     // tarball input case
     if (!this->continued) {
@@ -165,30 +181,135 @@ int NBody_Octree::kick_sub(const uint64_t& istart, const uint64_t& ipoints, cons
     std::advance(it, istart);
     std::advance(end, istart + ipoints);
 
+    auto& counters = this->prof_thread();
+    auto prof_start = this->prof_clock();
     for (it; it != end; ++it) {
-        it->second->ResetVelnForce();
-        this->TreeUpdateCForce(this->Tree, it->second);
-        this->TreeUpdateDForce(it->second);
-        it->second->UpdateVel(delta_t*this->len_scale_f);
+        (*it)->ResetVelnForce();
+        ForceSum f_coulomb;
+        this->TreeUpdateCForce(this->Tree, *it, f_coulomb, counters);
+        (*it)->SetForce(f_coulomb.sum);
+        this->TreeUpdateDForce(*it);
+        (*it)->UpdateVel(delta_t*this->len_scale_f);
+    }
+    this->prof_work(counters, PROF_FORCE, prof_start);
+
+    return 0;
+}
+
+// Sub method for grouped Kick OpenMP implementation.
+int NBody_Octree::kick_group_sub(const uint64_t& istart, const uint64_t& ipoints, const fp_t& delta_t)
+{
+    // Per thread work space... reused for every group.
+    InteractionList list;
+    CarrierVector group;
+
+    auto& counters = this->prof_thread();
+    auto prof_start = this->prof_clock();
+    for (auto i = istart; i < istart + ipoints; ++i) {
+        group.clear();
+        this->TreeGroups[i]->CollectCarriers(group);
+
+        // Bounding box of the group
+        auto g_min = group.front()->GetPos();
+        auto g_max = group.front()->GetPos();
+        for (auto& carrier : group) {
+            auto pos = carrier->GetPos();
+            g_min = Loc{
+                fp_min<fp_t>(g_min.x, pos.x),
+                fp_min<fp_t>(g_min.y, pos.y),
+                fp_min<fp_t>(g_min.z, pos.z) };
+            g_max = Loc{
+                fp_max<fp_t>(g_max.x, pos.x),
+                fp_max<fp_t>(g_max.y, pos.y),
+                fp_max<fp_t>(g_max.z, pos.z) };
+        }
+
+        // One walk for the whole group
+        list.clear();
+        this->Tree->BuildInteractionList(g_min, g_max, this->alpha, list);
+        counters.nodes += list.n_opened;
+        counters.pairs += list.size()*group.size();
+
+        for (auto& carrier : group)
+            carrier->ResetVelnForce();
+        this->PrepareList(FENG_TREE, list, (g_min + g_max) / FP_T(2.0));
+        this->ForceGroup(FENG_TREE, list, group, i);
+        for (auto& carrier : group) {
+            this->TreeUpdateDForce(carrier);
+            carrier->UpdateVel(delta_t*this->len_scale_f);
+        }
     }
+    this->prof_work(counters, PROF_FORCE, prof_start);
 
     return 0;
 }
 
-// Kick
+// Kick with grouped tree walk
+int NBody_Octree::KickGrouped(const fp_t& delta_t)
+{
+    // Prepare charge moments and groups.
+    this->Tree->UpdateMoments();
+    this->TreeGroups.clear();
+    this->Tree->CollectGroups(this->group_size, this->TreeGroups);
+
+    // Initialize Force calculation status bar.
+    this->ForceCal = ProgressBar("Force Est.", this->TreeGroups.size());
+
+#ifdef _OPENMP
+    uint64_t ithread, nthreads, ipoints, istart, npoints;
+    fp_t omp_dt = delta_t;
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_KICK, this->Carriers.size());
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ithread, nthreads, ipoints, istart, npoints)
+    {
+        npoints = this->TreeGroups.size();
+        ithread = omp_get_thread_num();
+        nthreads = omp_get_num_threads();
+        ipoints = npoints / nthreads;
+        istart = ithread * ipoints;
+        if (ithread == nthreads - 1)
+            ipoints = npoints - istart;
+        this->kick_group_sub(istart, ipoints, omp_dt);
+#pragma omp critical
+        {
+            this->ForceCal.Update(ipoints);
+        }
+    }
+#else
+    this->kick_group_sub(0, this->TreeGroups.size(), delta_t);
+    this->ForceCal.Update(this->TreeGroups.size());
+#endif /* #ifdef _OPENMP */
+
+    return 0;
+}
+
+// Kick with engine of this step
 int NBody_Octree::Kick(const fp_t& delta_t)
+{
+    return this->KickEngine(this->StepForceEngine(), delta_t);
+}
+
+// Kick with tree
+int NBody_Octree::KickNative(const fp_t& delta_t)
 {
     // Make tree... hoping it generates without error...
     if (this->MakeTree())
         return -1;
 
+    ProfScope prof(this, PROF_FORCE);
+
+    if (this->tree_walk_mode == BHT_WALK_GROUP)
+        return this->KickGrouped(delta_t);
+
     // Initialize Force calculation status bar.
     this->ForceCal = ProgressBar("Force Est.", this->Carriers.size());
     
 #ifdef _OPENMP
     uint64_t ithread, nthreads, ipoints, istart, npoints;
     fp_t omp_dt = delta_t;
-#pragma omp parallel private(ithread, nthreads, ipoints, istart, npoints)
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_KICK, this->Carriers.size());
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ithread, nthreads, ipoints, istart, npoints)
     {
         npoints = this->Carriers.size();
         ithread = omp_get_thread_num();
@@ -208,11 +329,14 @@ int NBody_Octree::Kick(const fp_t& delta_t)
     // Single thread method... (Recursive)
     auto carr_it = std::begin(this->Carriers);
     auto carr_it_end = std::end(this->Carriers);
+    auto& counters = this->prof_thread();
     for (carr_it; carr_it != carr_it_end; carr_it++) {
-        carr_it->second->ResetVelnForce();
-        this->TreeUpdateCForce(this->Tree, carr_it->second);
-        this->TreeUpdateDForce(carr_it->second);
-        carr_it->second->UpdateVel(delta_t*this->len_scale_f);
+        (*carr_it)->ResetVelnForce();
+        ForceSum f_coulomb;
+        this->TreeUpdateCForce(this->Tree, *carr_it, f_coulomb, counters);
+        (*carr_it)->SetForce(f_coulomb.sum);
+        this->TreeUpdateDForce(*carr_it);
+        (*carr_it)->UpdateVel(delta_t*this->len_scale_f);
         this->ForceCal.Update();
     }
 #endif /* #ifdef _OPENMP */
@@ -227,13 +351,13 @@ int NBody_Octree::Kick()
 // Drift
 int NBody_Octree::Drift(const fp_t& delta_t)
 {
+    this->AccumulateSignal(delta_t);
     this->update_all_carr_position(delta_t);
     return 0;
 }
 int NBody_Octree::Drift()
 {
-    this->update_all_carr_position(this->delta_t);
-    return 0;
+    return this->Drift(this->delta_t);
 }
 
 // Select --> consider just using friend class' Select.
@@ -251,26 +375,40 @@ void NBody_Octree::Select(const fp_t& tau)
 
 /**********************************************************/
 // Update force in Tree
-void NBody_Octree::TreeUpdateCForce(spOctree tree, spCarrier carrier)
+void NBody_Octree::TreeUpdateCForce(
+    const BHTree* tree, const spCarrier& carrier, ForceSum& f_sum,
+    ProfCounters& counters)
 {
-    auto dist = tree->GetCarrier()->GetPos().dist(carrier->GetPos());
-    auto oct_len = tree->GetOctant()->GetLength();
+    ++counters.nodes;
+
+    // Internal nodes don't hold carriers. Just go down.
+    if (!tree->HasCarriers()) {
+        if (tree->GetuNW()) { this->TreeUpdateCForce(tree->GetuNW(), carrier, f_sum, counters); }
+        if (tree->GetuNE()) { this->TreeUpdateCForce(tree->GetuNE(), carrier, f_sum, counters); }
+        if (tree->GetuSW()) { this->TreeUpdateCForce(tree->GetuSW(), carrier, f_sum, counters); }
+        if (tree->GetuSE()) { this->TreeUpdateCForce(tree->GetuSE(), carrier, f_sum, counters); }
+        if (tree->GetlNW()) { this->TreeUpdateCForce(tree->GetlNW(), carrier, f_sum, counters); }
+        if (tree->GetlNE()) { this->TreeUpdateCForce(tree->GetlNE(), carrier, f_sum, counters); }
+        if (tree->GetlSW()) { this->TreeUpdateCForce(tree->GetlSW(), carrier, f_sum, counters); }
+        if (tree->GetlSE()) { this->TreeUpdateCForce(tree->GetlSE(), carrier, f_sum, counters); }
+        return;
+    }
+
+    // Leaves: carriers within alpha of the leaf size.
+    auto oct_len = tree->GetOctant().GetLength();
     auto oct_len_max = fp_max<fp_t>(oct_len.x, oct_len.y, oct_len.z);
 
-    if ( tree->GetCarrier() != carrier && (dist / oct_len_max) < this->alpha ) {
-        // Update Coulomb force withing alpha...
-        carrier->AddForce(this->CoulombForce(carrier, tree->GetCarrier()));
-    }
+    for (auto item = tree->GetCarriers(); item; item = item->next) {
+        auto& other = *item->carrier;
+        if (other == carrier) continue;
 
-    // Recursively... run this crap to the end...
-    if (tree->GetuNW()) { this->TreeUpdateCForce(tree->GetuNW(), carrier); }
-    if (tree->GetuNE()) { this->TreeUpdateCForce(tree->GetuNE(), carrier); }
-    if (tree->GetuSW()) { this->TreeUpdateCForce(tree->GetuSW(), carrier); }
-    if (tree->GetuSE()) { this->TreeUpdateCForce(tree->GetuSE(), carrier); }
-    if (tree->GetlNW()) { this->TreeUpdateCForce(tree->GetlNW(), carrier); }
-    if (tree->GetlNE()) { this->TreeUpdateCForce(tree->GetlNE(), carrier); }
-    if (tree->GetlSW()) { this->TreeUpdateCForce(tree->GetlSW(), carrier); }
-    if (tree->GetlSE()) { this->TreeUpdateCForce(tree->GetlSE(), carrier); }
+        auto dist = other->GetPos().dist(carrier->GetPos());
+        if ((dist / oct_len_max) < this->alpha) {
+            // Update Coulomb force withing alpha...
+            f_sum.add(this->CoulombForce(carrier, other));
+            ++counters.pairs;
+        }
+    }
 }
 
 // Updating Drift force.
@@ -280,6 +418,208 @@ void NBody_Octree::TreeUpdateDForce(spCarrier carrier)
 }
 
 
+/**********************************************************/
+// Sampled force accuracy check
+//
+void NBody_Octree::SetForceAccuracy(
+    const uint64_t& every, const uint64_t& samples,
+    const fp_t& tol, const std::string& fname)
+{
+    this->accuracy_every = every ? every : ACC_EVERY_DEF;
+    this->accuracy_samples = samples ? samples : 1;
+    this->force_tol = tol > FP_T(0.0) ? tol : FP_T(0.0);
+    this->accuracy_file = fname;
+    this->accuracy_check = \
+        !this->accuracy_file.empty() || this->force_tol > FP_T(0.0);
+    if (this->accuracy_file.empty()) return;
+
+    std::ofstream ofs(this->accuracy_file, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write force accuracy to: " \
+            << this->accuracy_file << std::endl;
+        exit(-1);
+    }
+    ofs << "\"Step\",\"N\",\"Samples\",\"Alpha\"," \
+        << "\"RMS\",\"Max\",\"Next Alpha\"\n";
+    ofs.close();
+
+    this->accuracy_rows << std::scientific << std::setprecision(6);
+}
+
+// Alpha one step tighter or looser
+// --> Carrier walk: larger alpha adds more pairs.
+// --> Group walk: smaller alpha opens more nodes.
+fp_t NBody_Octree::step_alpha(const fp_t& a, bool tighter) const
+{
+    bool up = (this->tree_walk_mode == BHT_WALK_CARRIER) == tighter;
+    fp_t next = up ? a*ACC_ALPHA_STEP : a/ACC_ALPHA_STEP;
+    return fp_min<fp_t>(fp_max<fp_t>(next, ACC_ALPHA_MIN), ACC_ALPHA_MAX);
+}
+
+// Next alpha for measured relative rms error
+// --> Tightens while above force_tol, loosens while well below it
+//     but never back onto an alpha that recently failed.
+fp_t NBody_Octree::tune_alpha(const fp_t& rms)
+{
+    if (this->force_tol <= FP_T(0.0)) return this->alpha;
+
+    if (this->alpha_failed > FP_T(0.0) && \
+        ++this->alpha_failed_age > ACC_FORGET_CHECKS)
+        this->alpha_failed = FP_T(0.0);
+
+    if (rms > this->force_tol) {
+        this->alpha_failed = this->alpha;
+        this->alpha_failed_age = 0;
+
+        // One step per factor of two off the target, a few at most.
+        auto next = this->alpha;
+        auto n_steps = static_cast<int>(std::ceil(
+            std::log2(static_cast<double>(rms / this->force_tol))));
+        n_steps = std::min(std::max(n_steps, 1), ACC_MAX_TIGHTEN_STEPS);
+        for (int i = 0; i < n_steps; ++i)
+            next = this->step_alpha(next, true);
+        return next;
+    }
+
+    if (rms < this->force_tol*ACC_LOOSEN_MARGIN) {
+        auto next = this->step_alpha(this->alpha, false);
+        if (this->alpha_failed > FP_T(0.0)) {
+            // Stop short of the failed alpha (half a step of slack).
+            fp_t half_step = std::sqrt(ACC_ALPHA_STEP);
+            if (this->tree_walk_mode == BHT_WALK_CARRIER) {
+                if (next <= this->alpha_failed*half_step) return this->alpha;
+            }
+            else {
+                if (next >= this->alpha_failed/half_step) return this->alpha;
+            }
+        }
+        return next;
+    }
+
+    return this->alpha;
+}
+
+// Work units of the Group walk (the only walk Auto runs)
+// --> A group's list holds a shell of far nodes for every level from the
+//     group up to the root, save the top few opened anyway: pdbench's
+//     TreeWalk gives about log2(N/group_size) - 3 shells per carrier.
+double NBody_Octree::TreeWork(const double& n) const
+{
+    auto levels = std::log2(n/static_cast<double>(this->group_size)) - 3.0;
+    return n*std::max(levels, 1.0);
+}
+
+// Tuned alpha and cost model to checkpoint
+void NBody_Octree::SaveRunnerState(CheckpointHeader& header) const
+{
+    this->SaveEngineState(header);
+    header.tree_alpha = static_cast<double>(this->alpha);
+    header.tree_alpha_failed = static_cast<double>(this->alpha_failed);
+    header.tree_alpha_failed_age = this->alpha_failed_age;
+}
+
+// Tuned alpha and cost model from checkpoint
+void NBody_Octree::LoadRunnerState(const CheckpointHeader& header)
+{
+    this->LoadEngineState(header);
+    if (header.tree_alpha <= 0.0) return;
+    this->alpha = static_cast<fp_t>(header.tree_alpha);
+    this->alpha_failed = static_cast<fp_t>(header.tree_alpha_failed);
+    this->alpha_failed_age = header.tree_alpha_failed_age;
+}
+
+// Compares tree forces of sampled carriers to the direct sum.
+// --> Called right after a Kick, before carriers move.
+int NBody_Octree::CheckForceAccuracy()
+{
+    if (!this->accuracy_check) return 0;
+    if (this->step_engine != FENG_TREE) return 0;
+    if (this->sim_step % this->accuracy_every) return 0;
+
+    auto n_carr = this->Carriers.size();
+    if (n_carr < 2) return 0;
+
+    // Strided samples, offset rotates every check.
+    auto n_samples = std::min<uint64_t>(this->accuracy_samples, n_carr);
+    auto stride = n_carr / n_samples;
+    auto offset = (this->sim_step / this->accuracy_every) % stride;
+
+    double err_sq = 0.0, ref_sq = 0.0, err_max = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:err_sq,ref_sq) reduction(max:err_max)
+#endif
+    for (uint64_t s = 0; s < n_samples; ++s) {
+        auto& carrier = this->Carriers[offset + s*stride];
+
+        // Direct sum over all carriers
+        auto direct = ZeroForce;
+        for (auto& other : this->Carriers) {
+            if (other == carrier) continue;
+            direct += this->CoulombForce(carrier, other);
+        }
+
+        // Tree Coulomb force: Kick left Coulomb + drift in the carrier.
+        auto tree = carrier->GetForce();
+        tree -= this->DriftForce(carrier);
+
+        auto diff = tree;
+        diff -= direct;
+        auto d_sq = static_cast<double>(
+            diff.x*diff.x + diff.y*diff.y + diff.z*diff.z);
+        auto r_sq = static_cast<double>(
+            direct.x*direct.x + direct.y*direct.y + direct.z*direct.z);
+
+        err_sq += d_sq;
+        ref_sq += r_sq;
+        if (r_sq > 0.0)
+            err_max = std::max(err_max, std::sqrt(d_sq / r_sq));
+    }
+
+    // No reference force (i.e. all within Debye length): nothing to tune on.
+    auto rms = ref_sq > 0.0 ? std::sqrt(err_sq / ref_sq) : 0.0;
+    auto prev_alpha = this->alpha;
+    if (ref_sq > 0.0)
+        this->alpha = this->tune_alpha(static_cast<fp_t>(rms));
+
+    std::cout << "Force check: rms " << std::scientific << std::setprecision(3) \
+        << rms << ", max " << err_max << " over " << n_samples \
+        << " carriers (alpha " << std::defaultfloat << prev_alpha;
+    if (this->alpha != prev_alpha)
+        std::cout << " -> " << this->alpha;
+    std::cout << ")" << std::endl;
+
+    if (!this->accuracy_file.empty()) {
+        this->accuracy_rows \
+            << this->sim_step << "," << n_carr << "," << n_samples << "," \
+            << prev_alpha << "," << rms << "," << err_max << "," \
+            << this->alpha << "\n";
+    }
+
+    return 0;
+}
+
+// Writes buffered rows to file.
+int NBody_Octree::FlushForceAccuracy()
+{
+    if (this->accuracy_file.empty()) return 0;
+
+    std::ofstream ofs(this->accuracy_file, std::ios::out | std::ios::app);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write force accuracy to: " \
+            << this->accuracy_file << std::endl;
+        return -1;
+    }
+    ofs << this->accuracy_rows.str();
+    ofs.close();
+
+    this->accuracy_rows.str("");
+    this->accuracy_rows.clear();
+
+    return 0;
+}
+
+
 
 /**********************************************************/
 
@@ -288,7 +628,7 @@ void NBody_Octree::TreeUpdateDForce(spCarrier carrier)
 /**********************************************************/
 // Update carrier position
 //
-void NBody_Octree::update_carr_position(spCarrier& carrier)
+int NBody_Octree::update_carr_position(spCarrier& carrier)
 {
     // Implemented Debye length to solve the "too close carriers"
     // problem.
@@ -332,10 +672,7 @@ void NBody_Octree::update_carr_position(spCarrier& carrier)
             << ", " << carrier->GetPos().z \
             << ")" << std::endl;
         this->write_lost_carrier_info(carrier);
-        this->lost_carriers++;
-        this->add_to_rem(carrier);
-
-        return;
+        return CARR_LOST;
     }
 
     // Determine if the carrier is within the device or not.
@@ -345,17 +682,16 @@ void NBody_Octree::update_carr_position(spCarrier& carrier)
         //
         if (this->is_collectable(carrier, prev_pos)) {
             this->write_collected_carrier_info(carrier);
-            this->collected_carriers++;
-            this->add_to_rem(carrier);
+            return CARR_COLLECTED;
         }
-
-        return;
+        return CARR_STAY;
     }
 
+    return CARR_STAY;
 }
 
 // Same with update_carr_position but with given time.
-void NBody_Octree::update_carr_position(spCarrier& carrier, const fp_t& tau)
+int NBody_Octree::update_carr_position(spCarrier& carrier, const fp_t& tau)
 {
     // Implemented Debye length to solve the "too close carriers"
     // problem.
@@ -364,7 +700,9 @@ void NBody_Octree::update_carr_position(spCarrier& carrier, const fp_t& tau)
     Loc prev_pos = carrier->GetPos();
     carrier->UpdatePos(tau);
     // Update positions with mean free path estimation.
+    auto mfp_start = this->prof_clock();
     this->MFPAdj(carrier, tau);
+    this->prof_add_mfp(mfp_start);
     // New position...
     Loc new_pos = carrier->GetPos();
 
@@ -397,10 +735,7 @@ void NBody_Octree::update_carr_position(spCarrier& carrier, const fp_t& tau)
             << ", " << carrier->GetPos().z \
             << ")" << std::endl;
         this->write_lost_carrier_info(carrier);
-        this->lost_carriers++;
-        this->add_to_rem(carrier);
-
-        return;
+        return CARR_LOST;
     }
 
     // Determine if the carrier is within the device or not.
@@ -410,33 +745,42 @@ void NBody_Octree::update_carr_position(spCarrier& carrier, const fp_t& tau)
         //
         if (this->is_collectable(carrier, prev_pos)) {
             this->write_collected_carrier_info(carrier);
-            this->collected_carriers++;
-            this->add_to_rem(carrier);
+            return CARR_COLLECTED;
         }
-        return;
+        return CARR_STAY;
     }
+
+    return CARR_STAY;
 }
 
 // Segmentation of update_all_carr_position (OpenMP)
 // --> timed version
 //
 void NBody_Octree::update_all_carr_position_sub(
-    uint64_t& istart, uint64_t& ipoints, const fp_t& tau)
+    uint64_t& istart, uint64_t& ipoints, const fp_t& tau,
+    uint64_t& n_collected, uint64_t& n_lost,
+    StatsPartial& partial)
 {
-    auto it = std::begin(this->Carriers);
-    std::advance(it, istart);
-    auto end = std::begin(this->Carriers);
-    std::advance(end, istart + ipoints);
-
-    for (it; it != end; ++it) {
-        this->update_carr_position(it->second, tau);
-
-#pragma omp critical
-        {
-            this->LocCal.Update();
-        }
-
-    } /* for (it; it != end; ++it) */
+    bool stats_on = this->IsStatsOn();
+    auto& counters = this->prof_thread();
+    auto prof_start = this->prof_clock();
+    for (auto i = istart; i < istart + ipoints; ++i) {
+        fp_t t_collect = FP_T(-1.0);
+        auto carr_status = \
+            this->FastForward(this->Carriers[i], t_collect) ? \
+            CARR_COLLECTED : \
+            this->update_carr_position(this->Carriers[i], tau);
+        if (stats_on)
+            this->stats_add(
+                partial, *this->Carriers[i], carr_status, t_collect);
+        if (carr_status == CARR_STAY) continue;
+
+        if (carr_status == CARR_COLLECTED) n_collected++;
+        else n_lost++;
+        ++counters.removed;
+        this->add_to_rem(i);
+    } /* for (auto i = istart; i < istart + ipoints; ++i) */
+    this->prof_work(counters, PROF_DRIFT, prof_start);
 
     return;
 }
@@ -446,18 +790,25 @@ void NBody_Octree::update_all_carr_position_sub(
 //
 void NBody_Octree::update_all_carr_position(const fp_t& tau)
 {
+    this->prof_begin(PROF_DRIFT);
     this->LocCal = ProgressBar(
         "Loc Update.", this->Carriers.size());
 
-    //this->CarriersToRemove = CarrierList();
-    if (this->CarriersToRemove.size()) {
-        this->CarriersToRemove.clear();
-    }
+    this->init_rem();
+    std::vector<uint64_t> n_collected(this->CarriersToRemove.size(), 0);
+    std::vector<uint64_t> n_lost(this->CarriersToRemove.size(), 0);
+    this->init_stats_partials(this->CarriersToRemove.size());
+    this->init_event_log();
+    this->BeginFastForward(tau);
+    this->NextRngPass();
 
 #ifdef _OPENMP
     uint64_t ith, nth, ipoints, istart, npoints;
 
-#pragma omp parallel private(ith, nth, ipoints, istart, npoints)
+    {
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_DRIFT, this->Carriers.size());
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ith, nth, ipoints, istart, npoints)
     {
         npoints = this->Carriers.size();
         ith = omp_get_thread_num();
@@ -465,25 +816,33 @@ void NBody_Octree::update_all_carr_position(const fp_t& tau)
         ipoints = npoints / nth;
         istart = ith * ipoints;
         if (ith == nth - 1) ipoints = npoints - istart;
-        this->update_all_carr_position_sub(istart, ipoints, tau);
+        this->update_all_carr_position_sub(
+            istart, ipoints, tau, n_collected[ith], n_lost[ith],
+            this->stats_partials[ith]);
     }  /* #pragma omp parallel */
+    }
 
 #else
+    uint64_t istart = 0, ipoints = this->Carriers.size();
+    this->update_all_carr_position_sub(
+        istart, ipoints, tau, n_collected[0], n_lost[0],
+        this->stats_partials[0]);
+#endif
 
-    auto it = std::begin(this->Carriers);
-    while (true) {
-        this->update_carr_position(it->second, tau);
-        this->LocCal.Update();
-        if (it != std::end(this->Carriers)) ++it;
-        else break;
-    }
+    this->LocCal.Update(this->Carriers.size());
 
-#endif
+    for (auto cnt : n_collected) this->collected_carriers += cnt;
+    for (auto cnt : n_lost) this->lost_carriers += cnt;
+
+    // Merge streaming statistics of this drift.
+    this->MergeStats(tau);
+
+    this->prof_end(PROF_DRIFT);
 
     // Remove marked carriers.
-    for (auto ctr : this->CarriersToRemove) {
-        this->remove_carr(ctr);
-    }
+    this->prof_begin(PROF_REMOVE);
+    this->remove_marked_carr();
+    this->prof_end(PROF_REMOVE);
     return;
 }
 
@@ -523,11 +882,19 @@ int NBody_Octree::RunSingleShot()
 
     // Now actually runs the simulation
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Setting up delta_t
         if (!this->forced_delta_t) this->Select();
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -535,6 +902,7 @@ int NBody_Octree::RunSingleShot()
 
         if (!this->pass_forcecal) {
             this->Kick(this->delta_t);
+            this->CheckForceAccuracy();
         } /* if (!pass_forcecal) */
         else {
             this->pass_forcecal = false;
@@ -544,13 +912,35 @@ int NBody_Octree::RunSingleShot()
         this->Drift(this->delta_t);
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->FlushForceAccuracy();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
 
     // Wrapping up.
@@ -574,12 +964,20 @@ int NBody_Octree::RunSKDK()
     this->SimInit();
 
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Select
         if (!this->forced_delta_t) this->Select();
         // else this->Select(this->delta_t);
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -596,15 +994,38 @@ int NBody_Octree::RunSKDK()
 
         // 2nd half kick
         this->Kick(this->delta_t / 2.0);
+        this->CheckForceAccuracy();
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->FlushForceAccuracy();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
     // Wrapping up.
     this->SimFinishMessage();
@@ -627,12 +1048,20 @@ int NBody_Octree::RunSDKD()
     this->SimInit();
 
     while (this->Carriers.size()) {
+        // Sort carrier storage along Morton curve if it's due.
+        this->ReorderIfDue();
+
         // Select
         if (!this->forced_delta_t) this->Select();
         // else this->Select(this->delta_t);
 
         // Bulk Recombination (with substrate traps and acceptor/doners)
+        this->prof_begin(PROF_RECOMB);
         this->BulkRecombination();
+
+        // Electron-hole pair recombination
+        this->CarrToCarrRecombination();
+        this->prof_end(PROF_RECOMB);
         if (!this->Carriers.size()) break;
 
         // Prints out current simulation status to stdout.
@@ -644,18 +1073,41 @@ int NBody_Octree::RunSDKD()
 
         // Kick
         this->Kick(this->delta_t);
+        this->CheckForceAccuracy();
 
         // 2nd half drift
         this->Drift(this->delta_t / 2.0);
 
         // Write carrier location to log file.
+        this->prof_begin(PROF_OUTPUT);
         this->WriteCarriers();
 
+        // Write out carrier events of this step.
+        this->FlushEventLog();
+
+        // Induced current and cloud statistics of this step.
+        this->RecordSignal();
+        this->RecordStats();
+        this->prof_end(PROF_OUTPUT);
+
+        // Phase times and counters of this step.
+        this->RecordProfile();
+
         // Increase step # by 1
         this->sim_step++;
-        this->elapsed_time += this->delta_t;
+        this->AdvanceTime(this->delta_t);
+
+        // Write a checkpoint if it's due.
+        this->CheckpointIfDue();
     }
 
+    this->FlushEventLog();
+    this->DrainSignal();
+    this->FlushSignal();
+    this->FlushForceAccuracy();
+    this->WriteStatsSummary();
+    this->WriteProfile();
+    this->ReportForcePrecision();
     this->SimOutput.FlushText();
     // Wrapping up.
     this->SimFinishMessage();
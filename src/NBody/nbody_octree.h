@@ -22,6 +22,7 @@
 #include <fstream>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
 #include <deque>
 #include <vector>
 #include <set>
@@ -39,6 +40,13 @@
 #include "CTCForce.h"
 #include "recombination_nbody.h"
 #include "sim_file_io.h"
+#include "sim_checkpoint.h"
+#include "sim_signal.h"
+#include "sim_stats.h"
+#include "sim_profile.h"
+#include "sim_force_engine.h"
+#include "sim_fast_forward.h"
+#include "sim_reorder.h"
 
 #include "Octant.h"
 #include "BHTree.h"
@@ -50,6 +58,23 @@ using spOctant = std::shared_ptr<Octant>;
 using Octree = BHTree;
 using spOctree = std::shared_ptr<Octree>;
 
+// Tree walk modes
+// --> Carrier: walks the tree for each carrier.
+// --> Group: carriers in a leaf bucket share one walk.
+static const unsigned int BHT_WALK_CARRIER = 0;
+static const unsigned int BHT_WALK_GROUP = 1;
+static const unsigned int BHT_WALK_MAX = 1;
+
+// Force accuracy check defaults and alpha tuning limits
+static const uint64_t ACC_EVERY_DEF = 10;
+static const uint64_t ACC_SAMPLES_DEF = 64;
+static const fp_t ACC_ALPHA_STEP = 1.25;   // Multiplicative alpha step
+static const fp_t ACC_ALPHA_MIN = 1e-3;
+static const fp_t ACC_ALPHA_MAX = 1e6;
+static const int ACC_MAX_TIGHTEN_STEPS = 4;
+static const fp_t ACC_LOOSEN_MARGIN = 0.5; // Loosen only below tol*margin
+static const uint64_t ACC_FORGET_CHECKS = 10; // Retry a failed alpha after this
+
 /**
  *
  * The NBody class for octal tree division algorithm.
@@ -59,12 +84,20 @@ class NBody_Octree : \
     public virtual Physics::CTCForce, \
     public virtual Physics::Recombination_NBody, \
     public virtual NBodyFileIO, \
+    public virtual NBodyCheckpoint, \
+    public virtual NBodySignal, \
+    public virtual NBodyStats, \
+    public virtual NBodyProfile, \
+    public virtual NBodyForceEngine, \
+    public virtual NBodyFastForward, \
+    public virtual NBodyReorder, \
     public virtual NBodyVisual
 {
 
 private:
-    // The octal tree
-    spOctree Tree;
+    // The octal tree and its per step node storage
+    BHTree* Tree;
+    BHTreeArena TreeArena;
 
     //
     // Generate Tree from CarrierList
@@ -85,6 +118,33 @@ private:
     //
     fp_t alpha;
 
+    // Tree walk mode and max. carriers per group (Group mode)
+    unsigned int tree_walk_mode;
+    uint64_t group_size;
+
+    // Groups for current tree
+    std::vector<const BHTree*> TreeGroups;
+
+    // Sampled force accuracy check
+    // --> Every accuracy_every steps, tree forces of accuracy_samples
+    //     carriers are compared to the direct sum.
+    // --> force_tol > 0 moves alpha to the loosest value meeting it.
+    bool accuracy_check;
+    uint64_t accuracy_every;
+    uint64_t accuracy_samples;
+    fp_t force_tol;
+    std::string accuracy_file;
+    std::stringstream accuracy_rows;
+
+    // Loosest alpha seen missing force_tol (0: none) and its age
+    fp_t alpha_failed;
+    uint64_t alpha_failed_age;
+
+    // Alpha one step tighter (tighter = true) or looser
+    fp_t step_alpha(const fp_t& a, bool tighter) const;
+    // Next alpha for measured relative rms error
+    fp_t tune_alpha(const fp_t& rms);
+
 protected:
     // Initialize simulation
     int SimInit();
@@ -98,9 +158,25 @@ protected:
     // Kick: calculates force and velocity to all
     // carriers.
     int kick_sub(const uint64_t& istart, const uint64_t& ipoints, const fp_t& delta_t);
+    int kick_group_sub(const uint64_t& istart, const uint64_t& ipoints, const fp_t& delta_t);
+    int KickGrouped(const fp_t& delta_t);
     int Kick(const fp_t& delta_t);
     int Kick();
 
+    // Force engine: the tree is our own.
+    unsigned int NativeForceEngine() const
+    { return FENG_TREE; }
+    int KickNative(const fp_t& delta_t);
+    double TreeWork(const double& n) const;
+
+    // Checkpoint: tuned alpha and cost model carry over to the restart.
+    void SaveRunnerState(CheckpointHeader& header) const;
+    void LoadRunnerState(const CheckpointHeader& header);
+
+    // Fast forward: no diffusion in our drift.
+    bool DriftDiffuses() const
+    { return false; }
+
     // Drift: calculates displacements to all
     // carriers.
     int Drift(const fp_t& delta_t);
@@ -125,16 +201,26 @@ protected:
     bool pass_forcecal;
 
     // Methods for Tree Force calculation
-    void TreeUpdateCForce(spOctree tree, spCarrier carrier);
+    // --> Pair forces go to f_sum, set it to the carrier when done.
+    void TreeUpdateCForce(
+        const BHTree* tree, const spCarrier& carrier, ForceSum& f_sum,
+        ProfCounters& counters);
     void TreeUpdateDForce(spCarrier carrier);
 
     // Methods for Drift.
-    void update_carr_position(spCarrier& carrier);
-    void update_carr_position(spCarrier& carrier, const fp_t& tau);
+    // --> Returns CARR_STAY, CARR_COLLECTED or CARR_LOST
+    int update_carr_position(spCarrier& carrier);
+    int update_carr_position(spCarrier& carrier, const fp_t& tau);
     void update_all_carr_position_sub(
-        uint64_t& istart, uint64_t& ipoints, const fp_t& tau);
+        uint64_t& istart, uint64_t& ipoints, const fp_t& tau,
+        uint64_t& n_collected, uint64_t& n_lost,
+        StatsPartial& partial);
     void update_all_carr_position(const fp_t& tau);
 
+    // Force accuracy check after a Kick (if due) and its output
+    int CheckForceAccuracy();
+    int FlushForceAccuracy();
+
 public:
     // N-Body calculation algorithms
     int Run();
@@ -156,13 +242,59 @@ public:
         this->log_carrier_data_format = N;
     }
 
+    // Set up tree walk mode (BHT_WALK_CARRIER or BHT_WALK_GROUP)
+    void SetTreeWalkMode(unsigned int N)
+    {
+        if (N > BHT_WALK_MAX) N = BHT_WALK_CARRIER;
+        this->tree_walk_mode = N;
+    }
+
+    // Set up max. number of carriers per group
+    void SetGroupSize(const uint64_t& N)
+    {
+        this->group_size = N ? N : 1;
+    }
+
+    // Set up opening threshold alpha
+    void SetAlpha(const fp_t& new_alpha)
+    {
+        if (new_alpha > FP_T(0.0)) this->alpha = new_alpha;
+    }
+
+    // Set up max. carriers per leaf and depth limit of the tree
+    void SetLeafSize(const uint64_t& N)
+    {
+        this->TreeArena.leaf_size = N ? N : 1;
+    }
+    void SetTreeMaxDepth(const uint64_t& N)
+    {
+        this->TreeArena.max_depth = N;
+    }
+
+    // Set up sampled force accuracy check
+    // --> fname: csv output (empty: none)
+    // --> tol: target relative rms force error (0: report only)
+    // --> check is on if either fname or tol is given.
+    void SetForceAccuracy(
+        const uint64_t& every, const uint64_t& samples,
+        const fp_t& tol, const std::string& fname);
+
     // Constructors and Destructors
     NBody_Octree() : \
-        continued(false),
         Tree(nullptr),
+        alpha(FP_T(0.5)),
+        tree_walk_mode(BHT_WALK_CARRIER),
+        group_size(32),
+        accuracy_check(false),
+        accuracy_every(ACC_EVERY_DEF),
+        accuracy_samples(ACC_SAMPLES_DEF),
+        force_tol(FP_T(0.0)),
+        accuracy_file({}),
+        alpha_failed(FP_T(0.0)),
+        alpha_failed_age(0),
+        continued(false),
         input_data_filename({}),
-        pass_forcecal(false),
-        alpha(FP_T(0.5))
+        pass_forcecal(false)
     {
         spOctant spCV = std::make_shared<Octant>(Octant({}));
         this->sim_algorithm_str = "(Barnes-Hut)";
@@ -0,0 +1,124 @@
+/**
+ *
+ * output_policy.h
+ *
+ * Decimation and region of interest filters for carrier logs.
+ *
+ * Frame filters (every N steps, every dt of simulated time) decide
+ * whether a step is written at all. Carrier filters (subsample
+ * fraction, ROI box, distance to electrodes) decide which carriers
+ * of a written step go out. Every enabled filter has to pass, so
+ * they can be combined freely.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __output_policy_h__
+#define __output_policy_h__
+
+#include <cstdint>
+
+#include "fputils.h"
+#include "carrier.h"
+#include "sim_space.h"
+
+class CarrierOutputPolicy
+{
+public:
+    // Frame filters (0: off)
+    uint64_t every_steps;
+    fp_t every_time;           // (s)
+
+    // Carrier filters
+    fp_t fraction;             // kept fraction of carriers (1: all)
+    bool use_roi;
+    Box roi;                   // (um)
+    fp_t electrode_dist;       // (um) 0: off
+
+    // Simulated time of the last written frame
+    fp_t last_frame_time;
+    bool frame_written;
+
+    // Any filter enabled?
+    bool IsOn() const
+    {
+        return this->every_steps || this->every_time > FP_T(0.0) || \
+            this->HasCarrierFilter();
+    }
+
+    // Any carrier filter enabled?
+    bool HasCarrierFilter() const
+    {
+        return this->fraction < FP_T(1.0) || this->use_roi || \
+            this->electrode_dist > FP_T(0.0);
+    }
+
+    // Decides whether the current step is written.
+    // Call once per step; it remembers the last written frame.
+    bool FrameDue(const fp_int_t& step, const fp_t& time)
+    {
+        if (this->every_steps && \
+            step % static_cast<fp_int_t>(this->every_steps))
+            return false;
+
+        if (this->every_time > FP_T(0.0) && this->frame_written && \
+            time - this->last_frame_time < this->every_time)
+            return false;
+
+        this->last_frame_time = time;
+        this->frame_written = true;
+        return true;
+    }
+
+    // Decides whether a carrier is written.
+    //
+    // Subsampling hashes the carrier index, so the same carriers
+    // are picked at every step and their tracks stay complete.
+    //
+    bool Keep(const Carrier& carrier, const Box& device) const
+    {
+        if (this->fraction < FP_T(1.0)) {
+            uint64_t h = carrier.GetIndex() + 0x9E3779B97F4A7C15ULL;
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+            h ^= (h >> 31);
+            if (static_cast<double>(h >> 11) / 9007199254740992.0 >= \
+                static_cast<double>(this->fraction))
+                return false;
+        }
+
+        auto pos = carrier.GetPos();
+
+        if (this->use_roi) {
+            if (pos.x < this->roi.x_start || pos.x > this->roi.x_end || \
+                pos.y < this->roi.y_start || pos.y > this->roi.y_end || \
+                pos.z < this->roi.z_start || pos.z > this->roi.z_end)
+                return false;
+        }
+
+        // Electrodes sit on z_start and z_end planes.
+        if (this->electrode_dist > FP_T(0.0)) {
+            if (pos.z - device.z_start > this->electrode_dist && \
+                device.z_end - pos.z > this->electrode_dist)
+                return false;
+        }
+
+        return true;
+    }
+
+    CarrierOutputPolicy() : \
+        every_steps(0),
+        every_time(FP_T(0.0)),
+        fraction(FP_T(1.0)),
+        use_roi(false),
+        roi(Box{ 0, 0, 0, 0, 0, 0 }),
+        electrode_dist(FP_T(0.0)),
+        last_frame_time(FP_T(0.0)),
+        frame_written(false)
+    {;}
+    virtual ~CarrierOutputPolicy() {;}
+
+}; /* class CarrierOutputPolicy */
+
+#endif /* Include guard */
@@ -0,0 +1,407 @@
+/**
+ *
+ * sim_checkpoint.cc
+ *
+ * Binary checkpoint/restart for N-Body simulation (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <memory>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include "sim_checkpoint.h"
+
+static const char ckpt_magic[8] = { 'P', 'D', 'C', 'K', 'P', 'T', '\0', '\0' };
+
+// Carrier records are aligned to this in the file.
+static const uint64_t ckpt_align = 64;
+
+// Length of an output file (0: off or missing)
+static uint64_t ckpt_file_size(const std::string& fname)
+{
+    if (fname.empty()) return 0;
+    boost::system::error_code ec;
+    auto size = boost::filesystem::file_size(fname, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+// Cuts an output file back to its length at checkpoint, so rows
+// written after the checkpoint are not repeated on restart.
+static void ckpt_cut_file(const std::string& fname, const uint64_t& size)
+{
+    if (fname.empty() || !size) return;
+
+    auto cur_size = ckpt_file_size(fname);
+    if (cur_size < size) {
+        std::cerr << "Checkpoint: " << fname \
+            << " is shorter than at checkpoint, rows before restart are missing!!" \
+            << std::endl;
+        return;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(fname, size, ec);
+    if (ec) {
+        std::cerr << "Checkpoint: cannot cut back " << fname << std::endl;
+        exit(-1);
+    }
+}
+
+// Writes a checkpoint to checkpoint_file
+int NBodyCheckpoint::WriteCheckpoint()
+{
+    return this->WriteCheckpoint(this->checkpoint_file);
+}
+
+// Writes a checkpoint to given file
+//
+// The snapshot goes into <fname>.tmp first, then it is flushed to
+// disk and renamed over <fname>.
+//
+int NBodyCheckpoint::WriteCheckpoint(const std::string& fname)
+{
+#ifdef __MULTIPRECISION__
+    std::cerr << "Checkpoint: not supported with multiprecision build!!" << std::endl;
+    return -1;
+#else
+    if (fname.empty()) return -1;
+
+    // Buffered rows go to file first, so its length matches this
+    // checkpoint.
+    this->FlushSignal();
+    this->FlushStats();
+
+    // RNG state as text (portable across libstdc++ versions)
+    std::stringstream rng_ss;
+    rng_ss << this->sim_rng;
+    std::string rng_state = rng_ss.str();
+
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ckpt_magic, sizeof(ckpt_magic));
+    header.version = CKPT_VERSION;
+    header.carrier_size = sizeof(Carrier);
+    header.sim_step = static_cast<int64_t>(this->sim_step);
+    header.elapsed_time = static_cast<double>(this->elapsed_time);
+#ifdef __COMPENSATED__
+    header.elapsed_time_c = static_cast<double>(this->elapsed_time_c);
+#endif
+    header.delta_t = static_cast<double>(this->delta_t);
+    header.forced_delta_t = this->forced_delta_t ? 1 : 0;
+    header.collected_carriers = static_cast<uint64_t>(this->collected_carriers);
+    header.lost_carriers = static_cast<uint64_t>(this->lost_carriers);
+    header.num_elec = this->num_elec;
+    header.num_hole = this->num_hole;
+    header.type_mass[CARR_T_ELECTRON] = \
+        static_cast<double>(Carrier::type_mass[CARR_T_ELECTRON]);
+    header.type_mass[CARR_T_HOLE] = \
+        static_cast<double>(Carrier::type_mass[CARR_T_HOLE]);
+    header.rng_seed = this->rng_seed;
+    header.rng_pass = this->rng_pass;
+    header.signal_q_elec = static_cast<double>(this->signal_q_elec);
+    header.signal_q_hole = static_cast<double>(this->signal_q_hole);
+    header.signal_tau = static_cast<double>(this->signal_tau);
+    header.signal_q_total = static_cast<double>(this->signal_q_total);
+    header.signal_file_size = ckpt_file_size(this->signal_file);
+    header.n_signal_ghosts = this->signal_ghosts.size();
+    header.stats_bin[0] = static_cast<double>(this->stats_t_bin);
+    header.stats_bin[1] = static_cast<double>(this->stats_r_bin);
+    header.stats_has_ref = this->has_ref ? 1 : 0;
+    header.stats_ref[0] = static_cast<double>(this->ref_x);
+    header.stats_ref[1] = static_cast<double>(this->ref_y);
+    header.stats_step_tau = static_cast<double>(this->stats_step_tau);
+    header.onset_time = static_cast<double>(this->onset_time);
+    header.onset_step = static_cast<int64_t>(this->onset_step);
+    if (this->IsStatsOn()) {
+        header.stats_file_size = \
+            ckpt_file_size(this->stats_prefix + "_moments.csv");
+    }
+
+    uint64_t hist_size = 0;
+    for (auto e = 0; e < 2; ++e) {
+        for (auto t = 0; t < 2; ++t) {
+            header.hist_size[0][e][t] = this->hist_time[e][t].size();
+            header.hist_size[1][e][t] = this->hist_radius[e][t].size();
+            hist_size += header.hist_size[0][e][t] + header.hist_size[1][e][t];
+        }
+    }
+    hist_size *= sizeof(uint64_t);
+    header.last_frame_time = static_cast<double>(this->OutPolicy.last_frame_time);
+    header.frame_written = this->OutPolicy.frame_written ? 1 : 0;
+    this->SaveRunnerState(header);
+    header.n_carriers = this->Carriers.size();
+    header.rng_state_size = rng_state.size();
+
+    uint64_t ghosts_size = header.n_signal_ghosts*sizeof(SignalGhost);
+    uint64_t state_end = \
+        sizeof(header) + rng_state.size() + ghosts_size + hist_size;
+    header.data_offset = \
+        ((state_end + ckpt_align - 1)/ckpt_align)*ckpt_align;
+
+    std::string tmp_fname = fname + ".tmp";
+    FILE* fp = std::fopen(tmp_fname.c_str(), "wb");
+    if (!fp) {
+        std::cerr << "Checkpoint: cannot open " << tmp_fname << std::endl;
+        return -1;
+    }
+
+    bool ok = true;
+    ok = ok && std::fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && std::fwrite(rng_state.data(), 1, rng_state.size(), fp) == rng_state.size();
+    if (ghosts_size) {
+        ok = ok && std::fwrite(this->signal_ghosts.data(),
+            sizeof(SignalGhost), header.n_signal_ghosts, fp) == header.n_signal_ghosts;
+    }
+    for (auto e = 0; e < 2; ++e) {
+        for (auto t = 0; t < 2; ++t) {
+            auto& h_t = this->hist_time[e][t];
+            auto& h_r = this->hist_radius[e][t];
+            ok = ok && std::fwrite(h_t.data(), sizeof(uint64_t), h_t.size(), fp) == h_t.size();
+            ok = ok && std::fwrite(h_r.data(), sizeof(uint64_t), h_r.size(), fp) == h_r.size();
+        }
+    }
+
+    std::vector<char> padding(header.data_offset - state_end, 0);
+    ok = ok && std::fwrite(padding.data(), 1, padding.size(), fp) == padding.size();
+
+    for (auto& carrier : this->Carriers) {
+        if (!ok) break;
+        ok = std::fwrite(carrier.get(), sizeof(Carrier), 1, fp) == 1;
+    }
+
+    ok = ok && std::fflush(fp) == 0;
+#ifndef _MSC_VER
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = (std::fclose(fp) == 0) && ok;
+
+    if (!ok || std::rename(tmp_fname.c_str(), fname.c_str())) {
+        std::cerr << "Checkpoint: writing " << fname << " failed!!" << std::endl;
+        std::remove(tmp_fname.c_str());
+        return -1;
+    }
+
+    this->last_checkpoint_step = this->sim_step;
+    this->last_checkpoint_time = CLOCK_NOW;
+
+    return 0;
+#endif /* #ifdef __MULTIPRECISION__ */
+}
+
+// Writes a checkpoint if it's time to do so.
+int NBodyCheckpoint::CheckpointIfDue()
+{
+    if (this->checkpoint_file.empty()) return 0;
+
+    bool due = false;
+    if (this->checkpoint_steps && \
+        this->sim_step - this->last_checkpoint_step >= \
+            static_cast<fp_int_t>(this->checkpoint_steps))
+        due = true;
+
+    if (this->checkpoint_minutes > FP_T(0.0)) {
+        ChronoDuration since = ChronoTime::now() - this->last_checkpoint_time;
+        if (since.count() >= this->checkpoint_minutes*FP_T(60.0))
+            due = true;
+    }
+
+    if (!due) return 0;
+
+    auto rc = this->WriteCheckpoint();
+    if (!rc) {
+        std::cout << "Checkpoint written at step " << this->sim_step \
+            << ": " << this->checkpoint_file << std::endl;
+    }
+
+    return rc;
+}
+
+// Loads a checkpoint
+//
+// The file is mapped and carrier records are copied in one go into
+// a single block. Each spCarrier aliases its record in the block.
+//
+int NBodyCheckpoint::LoadCheckpoint(const std::string& fname)
+{
+#ifdef __MULTIPRECISION__
+    std::cerr << "Checkpoint: not supported with multiprecision build!!" << std::endl;
+    exit(-1);
+#else
+    const char* data = nullptr;
+    uint64_t file_size = 0;
+
+#ifndef _MSC_VER
+    int fd = open(fname.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+        std::cerr << "Checkpoint: cannot open " << fname << std::endl;
+        exit(-1);
+    }
+    file_size = static_cast<uint64_t>(st.st_size);
+    void* map = nullptr;
+    if (file_size) {
+        map = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            std::cerr << "Checkpoint: cannot map " << fname << std::endl;
+            exit(-1);
+        }
+        madvise(map, file_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    data = reinterpret_cast<const char*>(map);
+#else
+    std::ifstream ifs(fname, std::ios::binary | std::ios::ate);
+    if (!ifs.is_open()) {
+        std::cerr << "Checkpoint: cannot open " << fname << std::endl;
+        exit(-1);
+    }
+    file_size = static_cast<uint64_t>(ifs.tellg());
+    std::vector<char> file_buffer(file_size);
+    ifs.seekg(0);
+    ifs.read(file_buffer.data(), file_size);
+    data = file_buffer.data();
+#endif
+
+    // Check header
+    CheckpointHeader header;
+    if (file_size < sizeof(header)) {
+        std::cerr << "Checkpoint: " << fname << " is too short!!" << std::endl;
+        exit(-1);
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, ckpt_magic, sizeof(ckpt_magic)) || \
+        header.version != CKPT_VERSION || \
+        header.carrier_size != sizeof(Carrier)) {
+        std::cerr << "Checkpoint: " << fname \
+            << " is not a compatible checkpoint!!" << std::endl;
+        exit(-1);
+    }
+
+    uint64_t ghosts_size = header.n_signal_ghosts*sizeof(SignalGhost);
+    uint64_t hist_size = 0;
+    for (auto k = 0; k < 2; ++k)
+        for (auto e = 0; e < 2; ++e)
+            for (auto t = 0; t < 2; ++t)
+                hist_size += header.hist_size[k][e][t]*sizeof(uint64_t);
+    if (header.data_offset < \
+            sizeof(header) + header.rng_state_size + ghosts_size + hist_size || \
+        file_size != header.data_offset + header.n_carriers*sizeof(Carrier)) {
+        std::cerr << "Checkpoint: " << fname << " is truncated!!" << std::endl;
+        exit(-1);
+    }
+
+    // Simulation progress
+    this->sim_step = static_cast<fp_int_t>(header.sim_step);
+    this->elapsed_time = static_cast<fp_t>(header.elapsed_time);
+#ifdef __COMPENSATED__
+    this->elapsed_time_c = static_cast<fp_t>(header.elapsed_time_c);
+#endif
+    // delta_t given in command line wins over the checkpoint.
+    if (!this->forced_delta_t)
+        this->delta_t = static_cast<fp_t>(header.delta_t);
+    this->collected_carriers = static_cast<fp_int_t>(header.collected_carriers);
+    this->lost_carriers = static_cast<fp_int_t>(header.lost_carriers);
+    this->num_elec = header.num_elec;
+    this->num_hole = header.num_hole;
+    Carrier::type_mass[CARR_T_ELECTRON] = \
+        static_cast<fp_t>(header.type_mass[CARR_T_ELECTRON]);
+    Carrier::type_mass[CARR_T_HOLE] = \
+        static_cast<fp_t>(header.type_mass[CARR_T_HOLE]);
+    this->last_checkpoint_step = this->sim_step;
+
+    // RNG state
+    std::stringstream rng_ss(
+        std::string(data + sizeof(header), header.rng_state_size));
+    rng_ss >> this->sim_rng;
+    this->rng_seed = header.rng_seed;
+    this->rng_pass = header.rng_pass;
+
+    // Induced current
+    this->signal_q_elec = static_cast<fp_t>(header.signal_q_elec);
+    this->signal_q_hole = static_cast<fp_t>(header.signal_q_hole);
+    this->signal_tau = static_cast<fp_t>(header.signal_tau);
+    this->signal_q_total = static_cast<fp_t>(header.signal_q_total);
+    const char* state = data + sizeof(header) + header.rng_state_size;
+    this->signal_ghosts.resize(header.n_signal_ghosts);
+    if (ghosts_size)
+        std::memcpy(this->signal_ghosts.data(), state, ghosts_size);
+    state += ghosts_size;
+    ckpt_cut_file(this->signal_file, header.signal_file_size);
+
+    // Statistics: histograms continue with bin widths of the
+    // checkpoint if it had them.
+    if (header.stats_file_size) {
+        this->stats_t_bin = static_cast<fp_t>(header.stats_bin[0]);
+        this->stats_r_bin = static_cast<fp_t>(header.stats_bin[1]);
+    }
+    this->has_ref = header.stats_has_ref != 0;
+    this->ref_x = static_cast<fp_t>(header.stats_ref[0]);
+    this->ref_y = static_cast<fp_t>(header.stats_ref[1]);
+    this->stats_step_tau = static_cast<fp_t>(header.stats_step_tau);
+    this->onset_time = static_cast<fp_t>(header.onset_time);
+    this->onset_step = static_cast<fp_int_t>(header.onset_step);
+    for (auto e = 0; e < 2; ++e) {
+        for (auto t = 0; t < 2; ++t) {
+            auto& h_t = this->hist_time[e][t];
+            auto& h_r = this->hist_radius[e][t];
+            h_t.resize(header.hist_size[0][e][t]);
+            h_r.resize(header.hist_size[1][e][t]);
+            if (!h_t.empty())
+                std::memcpy(h_t.data(), state, h_t.size()*sizeof(uint64_t));
+            state += h_t.size()*sizeof(uint64_t);
+            if (!h_r.empty())
+                std::memcpy(h_r.data(), state, h_r.size()*sizeof(uint64_t));
+            state += h_r.size()*sizeof(uint64_t);
+        }
+    }
+    if (this->IsStatsOn()) {
+        ckpt_cut_file(
+            this->stats_prefix + "_moments.csv", header.stats_file_size);
+    }
+
+    // Carrier log: every_time frames keep their spacing.
+    this->OutPolicy.last_frame_time = static_cast<fp_t>(header.last_frame_time);
+    this->OutPolicy.frame_written = header.frame_written != 0;
+
+    this->LoadRunnerState(header);
+
+    // Carriers
+    auto block = std::make_shared<std::vector<Carrier>>(header.n_carriers);
+    if (header.n_carriers) {
+        std::memcpy(block->data(), data + header.data_offset,
+            header.n_carriers*sizeof(Carrier));
+    }
+
+    this->Carriers.clear();
+    this->Carriers.reserve(header.n_carriers);
+    for (auto& carrier : *block)
+        this->Carriers.emplace_back(block, &carrier);
+
+#ifndef _MSC_VER
+    if (data) munmap(const_cast<char*>(data), file_size);
+#endif
+
+    std::cout << "Restarting from checkpoint: " << fname \
+        << " (step " << this->sim_step << ", " \
+        << this->Carriers.size() << " carriers)" << std::endl;
+
+    return 0;
+#endif /* #ifdef __MULTIPRECISION__ */
+}
@@ -0,0 +1,153 @@
+/**
+ *
+ * sim_checkpoint.h
+ *
+ * Binary checkpoint/restart for N-Body simulation
+ *
+ * A checkpoint is a versioned snapshot of simulation progress
+ * (step, time and its Kahan term, delta_t, counters, carrier type
+ * masses, sim_rng state, per carrier stream seed and pass, induced
+ * current accumulators and ghosts, statistics histograms and onset,
+ * tuned tree opening threshold, force engine cost model and pick, time
+ * of the last carrier log frame) followed by the raw carrier records.
+ * It is written to a temporary file and renamed into place, so a crash
+ * never leaves a half written checkpoint.
+ *
+ * Current and moments csv files are flushed with the checkpoint, and
+ * on restart cut back to their length at that point and appended to.
+ *
+ * Not restored: per run diagnostics (profile, force accuracy and
+ * pair kernel precision reports, event echo count). These start over
+ * on restart, and the carrier log goes to a new file.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_checkpoint_h__
+#define __sim_checkpoint_h__
+
+#include <string>
+#include <cstdint>
+
+#include "sim_space.h"
+#include "sim_progress.h"
+#include "sim_signal.h"
+#include "sim_stats.h"
+#include "sim_force_engine.h"
+#include "visual.h"
+
+// Checkpoint file format version
+static const uint32_t CKPT_VERSION = 9;
+
+// Checkpoint file header. Carrier records start at header.data_offset.
+struct CheckpointHeader {
+    char     magic[8];          // "PDCKPT\0\0"
+    uint32_t version;           // CKPT_VERSION
+    uint32_t carrier_size;      // sizeof(Carrier)
+    int64_t  sim_step;
+    double   elapsed_time;      // (s)
+    double   elapsed_time_c;    // Kahan term (__COMPENSATED__ only, else 0)
+    double   delta_t;           // (s)
+    uint64_t forced_delta_t;
+    uint64_t collected_carriers;
+    uint64_t lost_carriers;
+    uint64_t num_elec;
+    uint64_t num_hole;
+    double   type_mass[2];      // Effective mass per carrier type (kg)
+    uint64_t rng_seed;          // Per carrier streams (CarrierRng)
+    uint64_t rng_pass;
+    double   signal_q_elec;     // Induced charge of current step (C)
+    double   signal_q_hole;
+    double   signal_tau;        // (s)
+    double   signal_q_total;    // (C)
+    uint64_t signal_file_size;  // Current file length at checkpoint
+    uint64_t n_signal_ghosts;   // SignalGhost records follow RNG state
+    double   stats_bin[2];      // Histogram bin widths, time (s), radius (um)
+    uint64_t stats_has_ref;
+    double   stats_ref[2];      // Radial reference x, y (um)
+    double   stats_step_tau;    // (s)
+    double   onset_time;        // (s)
+    int64_t  onset_step;
+    uint64_t stats_file_size;   // Moments file length at checkpoint
+    uint64_t hist_size[2][2][2]; // [time/radius][electrode][type], follow ghosts
+    double   tree_alpha;        // Opening threshold (0: not a tree runner)
+    double   tree_alpha_failed;
+    uint64_t tree_alpha_failed_age;
+    double   cost_coef[FENG_N_ENGINES]; // Force engine cost model (s per work unit)
+    uint64_t cost_calibrated;
+    uint64_t step_engine;       // Engine picked and the step it was for
+    int64_t  step_engine_step;
+    double   last_frame_time;   // Carrier log frame filter (s)
+    uint64_t frame_written;
+    uint64_t n_carriers;
+    uint64_t rng_state_size;    // RNG state text follows the header
+    uint64_t data_offset;
+};
+
+class NBodyCheckpoint : \
+    public virtual NBodySignal, \
+    public virtual NBodyStats, \
+    public virtual NBodyVisual
+{
+public:
+    // Checkpoint file and triggers (0: off)
+    std::string checkpoint_file;
+    uint64_t checkpoint_steps;
+    fp_t checkpoint_minutes;
+
+    // Restart from this checkpoint if given.
+    std::string restart_file;
+
+    // Last checkpoint (step and wall clock)
+    fp_int_t last_checkpoint_step;
+    ChronoFixedTime last_checkpoint_time;
+
+    // Writes a checkpoint now. Returns 0 on success.
+    int WriteCheckpoint();
+    int WriteCheckpoint(const std::string& fname);
+
+    // Writes a checkpoint if N steps or M minutes have passed.
+    int CheckpointIfDue();
+
+    // Loads simulation state and carriers from a checkpoint.
+    int LoadCheckpoint(const std::string& fname);
+
+    // Runner's own state (e.g. tuned opening threshold) in the header
+    virtual void SaveRunnerState(CheckpointHeader&) const {;}
+    virtual void LoadRunnerState(const CheckpointHeader&) {;}
+
+    // Set up checkpoint triggers and file
+    void SetCheckpoint(
+        const uint64_t& every_steps,
+        const fp_t& every_minutes,
+        const std::string& fname)
+    {
+        this->checkpoint_steps = every_steps;
+        this->checkpoint_minutes = every_minutes;
+        this->checkpoint_file = fname;
+        this->last_checkpoint_time = CLOCK_NOW;
+    }
+
+    // Set up restart file
+    void SetRestartFile(const std::string& fname)
+    { this->restart_file = fname; }
+
+    // Restarting or not
+    bool IsRestart() const
+    { return !this->restart_file.empty(); }
+
+    // Constructors and Destructors
+    NBodyCheckpoint() : \
+        checkpoint_file({}),
+        checkpoint_steps(0),
+        checkpoint_minutes(FP_T(0.0)),
+        restart_file({}),
+        last_checkpoint_step(0),
+        last_checkpoint_time(ChronoTime::now())
+    {;}
+    virtual ~NBodyCheckpoint() {;}
+
+};
+
+#endif /* Include guard */
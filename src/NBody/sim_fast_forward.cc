@@ -0,0 +1,154 @@
+/**
+ *
+ * sim_fast_forward.cc
+ *
+ * Closed form collection of isolated carriers (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <limits>
+
+#include "sim_fast_forward.h"
+
+// Carrier is put this far (um) past the electrode.
+static const fp_t FF_Z_PAST = FP_T(1e-6);
+
+// Prepares a drift of tau.
+void NBodyFastForward::BeginFastForward(const fp_t& tau)
+{
+    if (this->ff_step != this->sim_step) {
+        this->ff_step = this->sim_step;
+        this->ff_step_tau = FP_T(0.0);
+    }
+    this->ff_t0 = this->elapsed_time + this->ff_step_tau;
+    this->ff_tau = tau;
+    this->ff_step_tau += tau;
+
+    if (!this->IsFastForwardOn() || this->Carriers.empty()) return;
+
+    // Fronts of electron and hole clouds
+    for (auto t = 0; t < 2; ++t) {
+        this->ff_zmin[t] = std::numeric_limits<fp_t>::max();
+        this->ff_zmax[t] = std::numeric_limits<fp_t>::lowest();
+    }
+    for (auto& carrier : this->Carriers) {
+        auto t = carrier->GetTypeI();
+        auto z = carrier->GetPos().z;
+        this->ff_zmin[t] = std::min(this->ff_zmin[t], z);
+        this->ff_zmax[t] = std::max(this->ff_zmax[t], z);
+    }
+    // Largest Coulomb force possible: all the others at Debye length
+    auto debye = this->DebyeLength(this->Carriers.front());
+    this->ff_debye = debye*this->len_scale_f;
+    this->ff_f_rest = k_e*q_h*q_h* \
+        static_cast<fp_t>(this->Carriers.size() - 1)/(debye*debye);
+}
+
+// Collects the carrier at the electrode if isolated.
+bool NBodyFastForward::FastForward(spCarrier& carrier, fp_t& t_collect)
+{
+    if (!this->IsFastForwardOn()) return false;
+
+    // Space charge force against drift force
+    auto f_drift = this->DriftForce(carrier);
+    auto f_space = carrier->GetForce() - f_drift;
+    fp_t f_space_sq = \
+        f_space.x*f_space.x + f_space.y*f_space.y + f_space.z*f_space.z;
+    fp_t f_max_sq = this->ff_ratio*this->ff_ratio*f_drift.z*f_drift.z;
+    if (f_space_sq > f_max_sq || \
+        this->ff_f_rest*this->ff_f_rest > f_max_sq)
+        return false;
+
+    // Must head to the electrode the drift field pushes it to.
+    auto pos = carrier->GetPos();
+    auto vel = carrier->GetVel();
+    if (vel.z*f_drift.z <= FP_T(0.0)) return false;
+
+    // Ahead of the other type's cloud
+    auto other = (carrier->GetTypeI() == CARR_T_ELECTRON) ? \
+        CARR_T_HOLE : CARR_T_ELECTRON;
+    if (vel.z > FP_T(0.0) ? \
+        pos.z - this->ff_debye <= this->ff_zmax[other] : \
+        pos.z + this->ff_debye >= this->ff_zmin[other])
+        return false;
+
+    fp_t z_elec = (vel.z > FP_T(0.0)) ? \
+        this->silicon_dimension->z_end : this->silicon_dimension->z_start;
+    fp_t dz = z_elec - pos.z;
+    fp_t t_cross = dz / vel.z;
+    if (t_cross < FF_MIN_DRIFTS*this->ff_tau) return false;
+
+    // Spread per axis (um^2) of the random walk over t_cross
+    // --> MFPAdj: t/mft steps of v_th*mft in random directions
+    fp_t v_th = \
+        v_therm(this->temperature, carrier->GetMass())*this->len_scale_f;
+    fp_t var = t_cross*this->ff_mft*v_th*v_th/FP_T(3.0);
+    // --> Diffusion: one step of sqrt(Dt*tau) (cm) per drift
+    if (this->DriftDiffuses()) {
+        auto Mu = this->DetMaterial.GetSemi("Silicon",
+            (carrier->GetTypeI() == CARR_T_HOLE) ? "MUP" : "MUN");
+        auto Dt = k_B*this->temperature*Mu/q_h;
+        var += t_cross*Dt*this->len_scale_f*this->len_scale_f / \
+            (FP_T(3.0)*FP_T(1e4));
+    }
+
+    std::mt19937_64 rng(this->ff_seed ^ \
+        (carrier->GetIndex()*0x9E3779B97F4A7C15ULL) ^ \
+        (static_cast<uint64_t>(this->ff_step)*0xC2B2AE3D27D4EB4FULL));
+    std::normal_distribution<double> gauss(
+        0.0, sqrt(static_cast<double>(var)));
+
+    // z spread becomes the jitter of the crossing time.
+    fp_t t = t_cross + static_cast<fp_t>(gauss(rng))/fabs(vel.z);
+    t = std::max(t, FP_T(2.0)*this->ff_tau);
+
+    Loc new_pos{
+        pos.x + vel.x*t + static_cast<fp_t>(gauss(rng)),
+        pos.y + vel.y*t + static_cast<fp_t>(gauss(rng)),
+        z_elec + ((vel.z > FP_T(0.0)) ? FF_Z_PAST : -FF_Z_PAST) };
+
+    // Leaves through the sides: keep stepping it.
+    if (new_pos.x <= this->silicon_dimension->x_start || \
+        new_pos.x >= this->silicon_dimension->x_end || \
+        new_pos.y <= this->silicon_dimension->y_start || \
+        new_pos.y >= this->silicon_dimension->y_end)
+        return false;
+
+    // Rest of the induced charge after this drift
+    if (this->IsSignalOn()) {
+        this->AddSignalGhost(carrier->GetTypeI(),
+            (dz - vel.z*this->ff_tau)/(t - this->ff_tau),
+            this->ff_t0 + this->ff_tau, this->ff_t0 + t);
+    }
+
+    carrier->SetPos(new_pos);
+    t_collect = this->ff_t0 + t;
+    this->log_event(CARR_EVT_FAST_FORWARD, *carrier, *carrier, t_collect);
+
+    return true;
+}
+
+// Set up force ratio threshold
+void NBodyFastForward::SetFastForward(const fp_t& ratio)
+{
+    if (ratio < FP_T(0.0)) {
+        std::cerr << "Error!! Fast forward force ratio must be positive!!" \
+            << std::endl;
+        exit(-1);
+    }
+    this->ff_ratio = ratio;
+    if (!this->IsFastForwardOn()) return;
+
+    // Mean free time per MFPAdj call
+    // --> uniform_rand(1e-14, 1e-13) there is centered on 0, i.e. spans
+    //     +-4.5e-14 s, and negative draws skip the walk. Variance goes
+    //     with the mean of the positive part: width/8.
+    this->ff_mft = (FP_T(1e-13) - FP_T(1e-14))/FP_T(8.0);
+
+    this->ff_seed = this->sim_rng();
+}
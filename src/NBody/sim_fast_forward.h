@@ -0,0 +1,117 @@
+/**
+ *
+ * sim_fast_forward.h
+ *
+ * Closed form collection of isolated carriers
+ *
+ * Once a carrier has left the cloud, the space charge force on it is
+ * tiny next to the drift force and it just travels to the electrode
+ * at its current velocity. A carrier is isolated if
+ *
+ * - the Coulomb part of the force of the last Kick is below ff_ratio
+ *   of the drift force,
+ * - so is the largest force the rest of the cloud could exert, with
+ *   every other carrier at the Debye length, and
+ * - it is ahead of every carrier of the other type by more than the
+ *   Debye length, so no one can catch up with it and no force was
+ *   cut off by the Debye length.
+ *
+ * Then the crossing time of the electrode is computed directly:
+ *
+ * - t = dz/v_z, with v_z of the last Kick (i.e. current delta_t).
+ * - x-y move by v*t and spread by the Gaussian equivalent of the
+ *   Brownian (and diffusion) steps the carrier would have taken.
+ * - The same spread along z gives the jitter of t.
+ *
+ * Such carriers are collected right away with their own collection
+ * time, and their induced current is handed to NBodySignal.
+ *
+ * The bound on the rest of the cloud, k_e*q^2*(N-1)/debye^2, grows
+ * with N: it only passes while N <= 1 + ff_ratio*|F_drift|*debye^2/
+ * (k_e*q^2). For 4e5 V/m and a 6.9 um Debye length that is about 1300
+ * carriers at ff_ratio 0.1, or 130 at 0.01. Larger clouds are stepped
+ * as usual until they thin out, so fast forward takes over near the
+ * end of a run, i.e. the low density tail it is meant for.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_fast_forward_h__
+#define __sim_fast_forward_h__
+
+#include <cstdint>
+
+#include "CTCForce.h"
+#include "sim_file_io.h"
+#include "sim_signal.h"
+
+// Fast forward only if the crossing takes at least this many drifts.
+static const fp_t FF_MIN_DRIFTS = FP_T(4.0);
+
+class NBodyFastForward : \
+    public virtual Physics::CTCForce, \
+    public virtual NBodyFileIO, \
+    public virtual NBodySignal
+{
+public:
+    // Max. |Coulomb force|/|drift force| to fast forward (0: off)
+    fp_t ff_ratio;
+
+    // Mean free time per MFPAdj call (s)
+    fp_t ff_mft;
+
+    // Seed of per carrier random numbers
+    uint64_t ff_seed;
+
+    // Current drift: start time (s), length (s)
+    fp_t ff_t0;
+    fp_t ff_tau;
+
+    // z range (um) of each carrier type and Debye length (um)
+    fp_t ff_zmin[2];
+    fp_t ff_zmax[2];
+    fp_t ff_debye;
+
+    // Max. Coulomb force of the rest of the cloud (N), grows with N
+    fp_t ff_f_rest;
+
+    // Drift time elapsed within current step (s) and its step
+    fp_t ff_step_tau;
+    fp_int_t ff_step;
+
+    // Runner's drift applies CTCForce::Diffusion?
+    virtual bool DriftDiffuses() const = 0;
+
+    // Prepares a drift of tau. Call before the drift pass.
+    void BeginFastForward(const fp_t& tau);
+
+    // Collects the carrier at the electrode if isolated (thread safe).
+    // Returns true if collected, t_collect gets the collection time.
+    bool FastForward(spCarrier& carrier, fp_t& t_collect);
+
+    bool IsFastForwardOn() const
+    { return this->ff_ratio > FP_T(0.0); }
+
+    // Set up force ratio threshold (0: off)
+    void SetFastForward(const fp_t& ratio);
+
+    // Constructors and Destructors
+    NBodyFastForward() : \
+        ff_ratio(FP_T(0.0)),
+        ff_mft(FP_T(0.0)),
+        ff_seed(0),
+        ff_t0(FP_T(0.0)),
+        ff_tau(FP_T(0.0)),
+        ff_zmin{ FP_T(0.0), FP_T(0.0) },
+        ff_zmax{ FP_T(0.0), FP_T(0.0) },
+        ff_debye(FP_T(0.0)),
+        ff_f_rest(FP_T(0.0)),
+        ff_step_tau(FP_T(0.0)),
+        ff_step(-1)
+    {;}
+    virtual ~NBodyFastForward() {;}
+
+};
+
+#endif /* Include guard */
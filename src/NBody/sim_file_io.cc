@@ -64,11 +64,11 @@ int NBodyFileIO::set_logfile_name()
 
 // Return carrier location info as string
 //
-std::string NBodyFileIO::carrier_info(spCarrier& carrier)
+std::string NBodyFileIO::carrier_info(const Carrier& carrier)
 {
     std::string timestamp(this->print_elapsed_time());
-    std::string carrier_ID(carrier->GetID());
-    auto carrierPos = carrier->GetPos();
+    std::string carrier_ID(carrier.GetID());
+    auto carrierPos = carrier.GetPos();
 
     std::stringstream last_known_location;
     last_known_location \
@@ -86,67 +86,48 @@ std::string NBodyFileIO::carrier_info(spCarrier& carrier)
     return carrier_info_string.str();
 }
 
-
-// Write collected carrier info. to file.
-int NBodyFileIO::write_collected_carrier_info(spCarrier& carrier)
+// Prepare per thread event buffers.
+// --> Call before every parallel region that logs events: teams are
+//     at most omp_get_max_threads() threads.
+void NBodyFileIO::init_event_log()
 {
+    size_t n_buffers = 1;
+#ifdef _OPENMP
+    n_buffers = omp_get_max_threads();
+#endif
+    if (this->event_buffers.size() < n_buffers)
+        this->event_buffers.resize(n_buffers);
+}
 
-#pragma omp critical
+// Append an event to current thread's buffer.
+void NBodyFileIO::log_event(
+    const uint8_t& kind,
+    const Carrier& carrier, const Carrier& other,
+    const fp_t& time)
 {
-    this->simulation_logfile.open(
-        this->logfile_name, std::ios::out | std::ios::app);
-
-    if (this->simulation_logfile.is_open()) {
-        this->simulation_logfile \
-            << this->carrier_info(carrier) \
-            << std::endl;
+    size_t ith = 0;
+#ifdef _OPENMP
+    ith = omp_get_thread_num();
+#endif
+    if (ith >= this->event_buffers.size()) {
+        std::cerr << "Error!! Event log buffers are not ready for thread " \
+            << ith << "!!" << std::endl;
+        exit(-1);
     }
+    this->event_buffers[ith].push_back(CarrierEvent{ kind, carrier, other, time });
+}
 
-    std::cout << "Collected carrier: " \
-        << carrier->GetID() \
-        << " at (" << carrier->GetPos().x \
-        << ", " << carrier->GetPos().y \
-        << ", " << carrier->GetPos().z \
-        << ")" << std::endl;
-
-    //this->collected_carriers++;
-
-    this->simulation_logfile.close();
-
-} /* #pragma omp critical */
-
+// Write collected carrier info. to file.
+int NBodyFileIO::write_collected_carrier_info(spCarrier& carrier)
+{
+    this->log_event(CARR_EVT_COLLECTED, *carrier, *carrier);
     return 0;
 }
 
 // Write lost carrier info. to file.
 int NBodyFileIO::write_lost_carrier_info(spCarrier& carrier)
 {
-
-#pragma omp critical
-{
-
-    this->simulation_logfile.open(
-        this->logfile_name, std::ios::out | std::ios::app);
-
-    if (this->simulation_logfile.is_open()) {
-        this->simulation_logfile \
-            << "** LOST ** " \
-            << this->carrier_info(carrier) \
-            << std::endl;
-    }
-
-    std::cout << "Detected out of reach carrier: " \
-        << carrier->GetID() \
-        << " at (" << carrier->GetPos().x << ", " \
-        << carrier->GetPos().y << ", " \
-        << carrier->GetPos().z << ")" << std::endl;
-
-    //this->lost_carriers++;
-
-    this->simulation_logfile.close();
-
-} /* #pragma omp critical */
-
+    this->log_event(CARR_EVT_LOST, *carrier, *carrier);
     return 0;
 }
 
@@ -154,66 +135,124 @@ int NBodyFileIO::write_lost_carrier_info(spCarrier& carrier)
 int NBodyFileIO::write_recombination_carrier_info(
     spCarrier& carrier, spCarrier& other)
 {
-#pragma omp critical
-{
-
-    this->simulation_logfile.open(
-        this->logfile_name, std::ios::out | std::ios::app);
-
-    if (this->simulation_logfile.is_open()) {
-        this->simulation_logfile \
-            << "** RECOMBINATION ** " \
-            << this->carrier_info(carrier)  \
-            << std::endl \
-            << "** RECOMBINATION ** " \
-            << this->carrier_info(other)  \
-            << std::endl;
-    }
-
-    std::cout << "Detected recombination between: " \
-        << carrier->GetID() \
-        << " and " \
-        << other->GetID() \
-        << std::endl;
-
-    //this->lost_carriers += 2;
-
-    this->simulation_logfile.close();
-
-} /* #pragma omp critical */
-
+    this->log_event(CARR_EVT_RECOMB_PAIR, *carrier, *other);
     return 0;
 }
 
 // Write lost carrier info. to file.
 int NBodyFileIO::write_mat_recomb_carrier_info(spCarrier& carrier)
 {
-#pragma omp critical
+    this->log_event(CARR_EVT_RECOMB_MAT, *carrier, *carrier);
+    return 0;
+}
+
+// Writes buffered events to logfile and console.
+uint64_t NBodyFileIO::FlushEventLog()
 {
+    uint64_t n_events = 0;
+    for (auto& buffer : this->event_buffers)
+        n_events += buffer.size();
+
+    if (!n_events) {
+        this->init_event_log();
+        return 0;
+    }
+
+    std::stringstream ss_log;
+    std::stringstream ss_echo;
+    uint64_t n_echo = 0;
+
+    for (auto& buffer : this->event_buffers) {
+        for (auto& event : buffer) {
+            auto& carrier = event.carrier;
+            auto& other = event.other;
+            bool echo = n_echo < this->event_echo_limit;
+
+            switch (event.kind) {
+            case CARR_EVT_COLLECTED:
+                ss_log << this->carrier_info(carrier) << std::endl;
+                if (echo) {
+                    ss_echo << "Collected carrier: " \
+                        << carrier.GetID() \
+                        << " at (" << carrier.GetPos().x \
+                        << ", " << carrier.GetPos().y \
+                        << ", " << carrier.GetPos().z \
+                        << ")" << std::endl;
+                }
+                break;
+            case CARR_EVT_FAST_FORWARD:
+                ss_log << "** FAST-FORWARD ** " \
+                    << this->carrier_info(carrier) \
+                    << " at " << event.time << " s" << std::endl;
+                if (echo) {
+                    ss_echo << "Fast forwarded carrier: " \
+                        << carrier.GetID() \
+                        << " to (" << carrier.GetPos().x \
+                        << ", " << carrier.GetPos().y \
+                        << ", " << carrier.GetPos().z \
+                        << ") at " << event.time << " s" << std::endl;
+                }
+                break;
+            case CARR_EVT_LOST:
+                ss_log << "** LOST ** " \
+                    << this->carrier_info(carrier) << std::endl;
+                if (echo) {
+                    ss_echo << "Detected out of reach carrier: " \
+                        << carrier.GetID() \
+                        << " at (" << carrier.GetPos().x << ", " \
+                        << carrier.GetPos().y << ", " \
+                        << carrier.GetPos().z << ")" << std::endl;
+                }
+                break;
+            case CARR_EVT_RECOMB_PAIR:
+                ss_log << "** RECOMBINATION ** " \
+                    << this->carrier_info(carrier) << std::endl \
+                    << "** RECOMBINATION ** " \
+                    << this->carrier_info(other) << std::endl;
+                if (echo) {
+                    ss_echo << "Detected recombination between: " \
+                        << carrier.GetID() \
+                        << " and " \
+                        << other.GetID() \
+                        << std::endl;
+                }
+                break;
+            default:
+                ss_log << "** Recombination ** " \
+                    << this->carrier_info(carrier) << std::endl;
+                if (echo) {
+                    ss_echo << "Detected recombinated carrier: " \
+                        << carrier.GetID() \
+                        << " at (" << carrier.GetPos().x << ", " \
+                        << carrier.GetPos().y << ", " \
+                        << carrier.GetPos().z << ")" << std::endl;
+                }
+                break;
+            }
+            if (echo) ++n_echo;
+        }
+        buffer.clear();
+    }
 
     this->simulation_logfile.open(
         this->logfile_name, std::ios::out | std::ios::app);
-
     if (this->simulation_logfile.is_open()) {
-        this->simulation_logfile \
-            << "** Recombination ** " \
-            << this->carrier_info(carrier) \
-            << std::endl;
+        this->simulation_logfile << ss_log.str();
+        this->simulation_logfile.close();
     }
 
-    std::cout << "Detected recombinated carrier: " \
-        << carrier->GetID() \
-        << " at (" << carrier->GetPos().x << ", " \
-        << carrier->GetPos().y << ", " \
-        << carrier->GetPos().z << ")" << std::endl;
-
-    //this->lost_carriers++;
-
-    this->simulation_logfile.close();
+    if (this->event_echo_limit) {
+        std::cout << ss_echo.str();
+        if (n_events > n_echo) {
+            std::cout << "... and " << n_events - n_echo \
+                << " more carrier events (see " \
+                << this->logfile_name << ")" << std::endl;
+        }
+    }
 
-} /* #pragma omp critical */
+    this->init_event_log();
 
-    return 0;
+    return n_events;
 }
 
 // Returns base filename
@@ -286,7 +325,7 @@ int NBodyFileIO::generate_carriers()
                                 q_e, carr_pos, carr_vel,
                                 electron_mass,
                                 carr_index);
-                        this->Carriers[carr_index] = Electron;
+                        this->Carriers.push_back(Electron);
                         ++carr_index;
                         ++cnt_elec;
                         this->CarrierReadInProgress.Update(1);
@@ -306,7 +345,7 @@ int NBodyFileIO::generate_carriers()
                                 q_h, carr_pos, carr_vel,
                                 hole_mass,
                                 carr_index);
-                        this->Carriers[carr_index] = Hole;
+                        this->Carriers.push_back(Hole);
                         ++carr_index;
                         ++cnt_hole;
                         this->CarrierReadInProgress.Update(1);
@@ -370,36 +409,17 @@ int NBodyFileIO::generate_carriers_db()
         << std::endl;
 
     // Read carriers with load_carr library.
-    this->Carriers = this->GetCarriers(this->db_file);
-
-    // Setup proper mass for each carriers and also count 
-    // electron and holes.
-    //
-    std::cout \
-        << "Updating carrier mass." \
-        << std::endl;
-
+    // Masses are set up and electrons/holes are counted as
+    // carriers are read in.
     auto electron_mass = \
         this->DetMaterial.GetSemi("Silicon", "MVTHN")*m_elec;
     auto hole_mass = \
         this->DetMaterial.GetSemi("Silicon", "MVTHP")*m_elec;
+    this->SetReadMass(electron_mass, hole_mass);
 
-    auto carr_it = std::begin(this->Carriers);
-    for (carr_it;
-        carr_it != std::end(this->Carriers); ++carr_it) {
-
-        auto spTmpCarr = carr_it->second;
-        auto carr_charge = spTmpCarr->GetCharge();
-
-        if (fp_mt(carr_charge, static_cast<fp_t>(0.0))) {
-            spTmpCarr->SetMass(hole_mass);
-            this->num_hole++;
-        }
-        else {
-            spTmpCarr->SetMass(electron_mass);
-            this->num_elec++;
-        }
-    }
+    this->Carriers = this->GetCarriers(this->db_file);
+    this->num_elec += this->GetNumElecRead();
+    this->num_hole += this->GetNumHoleRead();
 
     // Setting up simulation time.
     this->elapsed_time = this->sim_time;
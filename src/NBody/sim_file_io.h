@@ -22,6 +22,25 @@
 
 #include "sim_space.h"
 
+// Carrier event kinds for the event log
+static const uint8_t CARR_EVT_COLLECTED = 0;
+static const uint8_t CARR_EVT_LOST = 1;
+static const uint8_t CARR_EVT_RECOMB_PAIR = 2;
+static const uint8_t CARR_EVT_RECOMB_MAT = 3;
+static const uint8_t CARR_EVT_FAST_FORWARD = 4;
+
+// Default max. number of events echoed to console per step.
+static const uint64_t EVENT_ECHO_DEF = 10;
+
+// An event: snapshots of the carrier(s) involved.
+struct CarrierEvent {
+    uint8_t kind;
+    Carrier carrier;
+    Carrier other;
+    fp_t time;      // Collection time (s) if known, negative otherwise
+};
+using CarrierEventList = std::vector<CarrierEvent>;
+
 class NBodyFileIO : public virtual sim_space
 {
 public:
@@ -37,15 +56,33 @@ public:
     std::string time_string;
     std::ofstream simulation_logfile;
 
+    // Event buffers, one per thread. Flushed once per step.
+    std::vector<CarrierEventList> event_buffers;
+    // Max. number of events echoed to console per step (0: off)
+    uint64_t event_echo_limit;
+
     // Methods
     int set_logfile_name();
-    std::string carrier_info(spCarrier& carrier);
+    std::string carrier_info(const Carrier& carrier);
+    void init_event_log();
+    void log_event(
+        const uint8_t& kind,
+        const Carrier& carrier, const Carrier& other,
+        const fp_t& time = FP_T(-1.0));
     int write_collected_carrier_info(spCarrier& carrier);
     int write_lost_carrier_info(spCarrier& carrier);
     int write_recombination_carrier_info(spCarrier& carrier, spCarrier& other);
     int write_mat_recomb_carrier_info(spCarrier& carrier);
     std::string GetBaseFilename();
 
+    // Writes buffered events to logfile and console.
+    // Returns number of events written.
+    uint64_t FlushEventLog();
+
+    // Set up console echo limit per step (0: off)
+    void SetEventEchoLimit(const uint64_t& N)
+    { this->event_echo_limit = N; }
+
     // Generate carriers from csv file
     int generate_carriers();
     // Generate carriers from database file
@@ -57,7 +94,8 @@ public:
         db_file(nullptr),
         logfile_name(""),
         time_string(""),
-        simulation_logfile()
+        simulation_logfile(),
+        event_echo_limit(EVENT_ECHO_DEF)
     {;}
     virtual ~NBodyFileIO() {;}
 
@@ -0,0 +1,566 @@
+/**
+ *
+ * sim_force_engine.cc
+ *
+ * Pluggable Coulomb force engines for N-Body simulation
+ * (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "sim_force_engine.h"
+#include "sim_checkpoint.h"
+
+// Carriers sharing the full source list in Direct engine
+static const uint64_t FENG_DIRECT_CHUNK = 64;
+
+// Seconds since given time point
+static double seconds_since(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ *
+ * Engines
+ *
+**/
+// Direct: every carrier against the whole cloud.
+void NBodyForceEngine::CForceDirect()
+{
+    auto n_carr = this->Carriers.size();
+    if (!n_carr) return;
+
+    InteractionList all;
+    for (auto& carrier : this->Carriers)
+        all.push(carrier->GetPos(), carrier->GetCharge());
+    // Cloud is one tile: anchor at its first carrier.
+    this->PrepareList(FENG_DIRECT, all, this->Carriers.front()->GetPos());
+
+    auto n_chunks = (n_carr + FENG_DIRECT_CHUNK - 1) / FENG_DIRECT_CHUNK;
+
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_KICK, n_carr);
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1)
+    {
+        CarrierVector group;
+        auto& counters = this->prof_thread();
+        auto prof_start = this->prof_clock();
+
+#pragma omp for schedule(dynamic)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_chunks); ++i) {
+            auto begin = i*FENG_DIRECT_CHUNK;
+            auto end = std::min<uint64_t>(begin + FENG_DIRECT_CHUNK, n_carr);
+            group.assign(
+                this->Carriers.begin() + begin, this->Carriers.begin() + end);
+            this->ForceGroup(FENG_DIRECT, all, group, i);
+            counters.pairs += group.size()*(n_carr - 1);
+        }
+
+        this->prof_work(counters, PROF_FORCE, prof_start);
+    }
+}
+
+// Mesh: near cells exact, far cells as monopoles.
+void NBodyForceEngine::CForceMesh()
+{
+    auto n_carr = this->Carriers.size();
+    if (!n_carr) return;
+
+    // Grid over the cloud bounding box
+    auto b_min = this->Carriers.front()->GetPos();
+    auto b_max = b_min;
+    for (auto& carrier : this->Carriers) {
+        auto pos = carrier->GetPos();
+        b_min = Loc{
+            fp_min<fp_t>(b_min.x, pos.x),
+            fp_min<fp_t>(b_min.y, pos.y),
+            fp_min<fp_t>(b_min.z, pos.z) };
+        b_max = Loc{
+            fp_max<fp_t>(b_max.x, pos.x),
+            fp_max<fp_t>(b_max.y, pos.y),
+            fp_max<fp_t>(b_max.z, pos.z) };
+    }
+
+    auto n_axis = static_cast<int64_t>(std::ceil(
+        std::cbrt(static_cast<double>(n_carr) / static_cast<double>(MESH_PER_CELL))));
+    n_axis = std::min<int64_t>(std::max<int64_t>(n_axis, 1), MESH_MAX_CELLS);
+
+    // Cells per unit length along each axis (flat axes: one cell)
+    auto inv_h = [&](const fp_t& lo, const fp_t& hi) {
+        return hi > lo ? static_cast<double>(n_axis) / static_cast<double>(hi - lo) : 0.0;
+    };
+    double inv_hx = inv_h(b_min.x, b_max.x);
+    double inv_hy = inv_h(b_min.y, b_max.y);
+    double inv_hz = inv_h(b_min.z, b_max.z);
+
+    auto axis_cell = [&](const fp_t& p, const fp_t& lo, const double& inv) {
+        auto c = static_cast<int64_t>(static_cast<double>(p - lo)*inv);
+        return std::min<int64_t>(std::max<int64_t>(c, 0), n_axis - 1);
+    };
+
+    // Bucket carriers by cell (counting sort)
+    auto n_cells = static_cast<uint64_t>(n_axis*n_axis*n_axis);
+    std::vector<uint64_t> carr_cell(n_carr);
+    std::vector<uint64_t> cell_start(n_cells + 1, 0);
+    for (uint64_t i = 0; i < n_carr; ++i) {
+        auto pos = this->Carriers[i]->GetPos();
+        auto cx = axis_cell(pos.x, b_min.x, inv_hx);
+        auto cy = axis_cell(pos.y, b_min.y, inv_hy);
+        auto cz = axis_cell(pos.z, b_min.z, inv_hz);
+        carr_cell[i] = static_cast<uint64_t>((cz*n_axis + cy)*n_axis + cx);
+        ++cell_start[carr_cell[i] + 1];
+    }
+    for (uint64_t c = 0; c < n_cells; ++c)
+        cell_start[c + 1] += cell_start[c];
+
+    std::vector<uint64_t> order(n_carr);
+    std::vector<uint64_t> fill(cell_start.begin(), cell_start.end() - 1);
+    for (uint64_t i = 0; i < n_carr; ++i)
+        order[fill[carr_cell[i]]++] = i;
+
+    // Occupied cells and their monopoles (charge at carrier centroid)
+    std::vector<uint64_t> occupied;
+    std::vector<Loc> occ_pos;
+    std::vector<fp_t> occ_q;
+    for (uint64_t c = 0; c < n_cells; ++c) {
+        auto n_in = cell_start[c + 1] - cell_start[c];
+        if (!n_in) continue;
+
+        auto centroid = Loc{ FP_T(0.0), FP_T(0.0), FP_T(0.0) };
+        auto q = FP_T(0.0);
+        for (auto k = cell_start[c]; k < cell_start[c + 1]; ++k) {
+            auto& carrier = this->Carriers[order[k]];
+            centroid += carrier->GetPos();
+            q += carrier->GetCharge();
+        }
+        occupied.push_back(c);
+        occ_pos.push_back(centroid / static_cast<fp_t>(n_in));
+        occ_q.push_back(q);
+    }
+
+    auto n_occ = occupied.size();
+
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_KICK, n_carr);
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1)
+    {
+        InteractionList list;
+        CarrierVector group;
+        auto& counters = this->prof_thread();
+        auto prof_start = this->prof_clock();
+
+#pragma omp for schedule(dynamic)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_occ); ++i) {
+            auto c = static_cast<int64_t>(occupied[i]);
+            auto cx = c % n_axis;
+            auto cy = (c / n_axis) % n_axis;
+            auto cz = c / (n_axis*n_axis);
+
+            list.clear();
+            group.clear();
+
+            // Near: carriers of this and neighbour cells
+            for (auto nz = std::max<int64_t>(cz - 1, 0); nz <= std::min(cz + 1, n_axis - 1); ++nz)
+            for (auto ny = std::max<int64_t>(cy - 1, 0); ny <= std::min(cy + 1, n_axis - 1); ++ny)
+            for (auto nx = std::max<int64_t>(cx - 1, 0); nx <= std::min(cx + 1, n_axis - 1); ++nx) {
+                auto nc = (nz*n_axis + ny)*n_axis + nx;
+                for (auto k = cell_start[nc]; k < cell_start[nc + 1]; ++k) {
+                    auto& carrier = this->Carriers[order[k]];
+                    list.push(carrier->GetPos(), carrier->GetCharge());
+                }
+            }
+
+            // Far: monopoles of every other occupied cell
+            for (uint64_t j = 0; j < n_occ; ++j) {
+                auto oc = static_cast<int64_t>(occupied[j]);
+                auto ox = oc % n_axis;
+                auto oy = (oc / n_axis) % n_axis;
+                auto oz = oc / (n_axis*n_axis);
+                if (std::abs(ox - cx) <= 1 && std::abs(oy - cy) <= 1 && \
+                    std::abs(oz - cz) <= 1) continue;
+                if (occ_q[j] == FP_T(0.0)) continue;
+                list.push(occ_pos[j], occ_q[j]);
+            }
+
+            for (auto k = cell_start[c]; k < cell_start[c + 1]; ++k)
+                group.push_back(this->Carriers[order[k]]);
+
+            this->PrepareList(FENG_MESH, list, occ_pos[i]);
+            this->ForceGroup(FENG_MESH, list, group, i);
+            counters.pairs += list.size()*group.size();
+        }
+
+        this->prof_work(counters, PROF_FORCE, prof_start);
+    }
+}
+
+/**
+ *
+ * Pair kernel precision
+ *
+**/
+// Single precision copy of the list if the engine uses it
+void NBodyForceEngine::PrepareList(
+    const unsigned int& engine, InteractionList& list, const Loc& anchor)
+{
+    if (this->IsForceFloat(engine)) list.to_float(anchor);
+}
+
+// Pair kernel of an engine on a tile
+void NBodyForceEngine::ForceGroup(
+    const unsigned int& engine, const InteractionList& list,
+    CarrierVector& group, const uint64_t& tile)
+{
+    auto prec = this->force_prec[engine];
+    if (prec == PAIR_PREC_DOUBLE) {
+        this->CoulombForceGroup(list, group);
+        return;
+    }
+
+    if (!(tile % FENG_PREC_CHECK_EVERY) && !this->calibrating)
+        this->CheckForcePrecision(engine, list, group);
+    this->CoulombForceGroup(list, group, prec);
+}
+
+// Engine's precision against double on the tile
+// --> Both kernels sum into buffers: the carriers are left alone and
+//     nothing is rounded to the carrier's force on the way.
+void NBodyForceEngine::CheckForcePrecision(
+    const unsigned int& engine, const InteractionList& list,
+    const CarrierVector& group)
+{
+    std::vector<double> ref, test;
+    this->CoulombForceGroupSum(list, group, PAIR_PREC_DOUBLE, ref);
+    this->CoulombForceGroupSum(list, group, this->force_prec[engine], test);
+
+    // Max. error is relative to the tile's rms force: a carrier whose
+    // forces nearly cancel would blow up its own relative error.
+    double err_sq = 0.0, ref_sq = 0.0, d_sq_max = 0.0;
+    for (size_t i = 0; i < ref.size(); i += 3) {
+        double d_sq = 0.0;
+        for (size_t k = i; k < i + 3; ++k) {
+            auto d = test[k] - ref[k];
+            d_sq += d*d;
+            ref_sq += ref[k]*ref[k];
+        }
+        err_sq += d_sq;
+        d_sq_max = std::max(d_sq_max, d_sq);
+    }
+    auto err_max = ref_sq > 0.0 ? \
+        std::sqrt(d_sq_max*static_cast<double>(group.size())/ref_sq) : 0.0;
+
+#pragma omp critical (force_precision)
+    {
+        auto& stats = this->PrecStats[engine];
+        stats.err_sq += err_sq;
+        stats.ref_sq += ref_sq;
+        stats.err_max = std::max(stats.err_max, err_max);
+        ++stats.tiles;
+    }
+}
+
+// Prints error of every non double engine.
+void NBodyForceEngine::ReportForcePrecision() const
+{
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine) {
+        auto& stats = this->PrecStats[engine];
+        if (!stats.tiles) continue;
+
+        auto rms = stats.ref_sq > 0.0 ? \
+            std::sqrt(stats.err_sq / stats.ref_sq) : 0.0;
+        std::cout << PairPrecisionName(this->force_prec[engine]) \
+            << " precision " << ForceEngineName(engine) \
+            << " force error against double: rms " \
+            << std::scientific << std::setprecision(3) << rms \
+            << ", max " << stats.err_max << " of tile rms" << std::defaultfloat \
+            << " over " << stats.tiles << " tiles" << std::endl;
+    }
+}
+
+// Full kick with given engine
+int NBodyForceEngine::KickEngine(const unsigned int& engine, const fp_t& delta_t)
+{
+    auto t_start = std::chrono::steady_clock::now();
+    auto n_carr = this->Carriers.size();
+
+    int ret = 0;
+    if (engine == this->NativeForceEngine()) {
+        ret = this->KickNative(delta_t);
+    }
+    else {
+        ProfScope prof(this, PROF_FORCE);
+
+        // Per carrier work here is tiny: follow the drift's team size.
+        auto team = this->OmpPolicy.Team(OMP_R_DRIFT, n_carr);
+#pragma omp parallel for num_threads(team) if(team > 1)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_carr); ++i)
+            this->Carriers[i]->ResetVelnForce();
+
+        if (engine == FENG_MESH) this->CForceMesh();
+        else this->CForceDirect();
+
+#pragma omp parallel for num_threads(team) if(team > 1)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_carr); ++i) {
+            auto& carrier = this->Carriers[i];
+            carrier->AddForce(this->DriftForce(carrier));
+            carrier->UpdateVel(delta_t*this->len_scale_f);
+        }
+    }
+
+    // Correct cost model with what it actually took.
+    if (this->force_engine == FENG_AUTO && this->CostModel.calibrated) {
+        auto work = this->EngineWork(engine, n_carr);
+        if (work > 0.0) {
+            auto& coef = this->CostModel.coef[engine];
+            coef = (1.0 - FENG_COST_EMA)*coef + \
+                FENG_COST_EMA*seconds_since(t_start)/work;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ *
+ * Engine selection
+ *
+**/
+// Work units of an engine for N carriers
+// --> Tree and Mesh both fit the cloud's bounding box, so its size
+//     doesn't enter: only N does.
+double NBodyForceEngine::EngineWork(
+    const unsigned int& engine, const uint64_t& N) const
+{
+    auto n = static_cast<double>(N);
+    if (N < 2) return n;
+
+    switch (engine) {
+    case FENG_DIRECT:
+        return n*n;
+
+    case FENG_TREE:
+        return this->TreeWork(n);
+
+    case FENG_MESH: {
+        // Cells fill up past MESH_PER_CELL once the grid is capped.
+        auto max_cells = std::pow(static_cast<double>(MESH_MAX_CELLS), 3);
+        auto per_cell = std::max(static_cast<double>(MESH_PER_CELL), n/max_cells);
+        return n*(27.0*per_cell + n/per_cell);
+    }
+    }
+
+    return 0.0;
+}
+
+// Work units of a tree walk for n carriers
+// --> Runners with a tree give their own walk's.
+double NBodyForceEngine::TreeWork(const double& n) const
+{
+    return n*std::max(std::log2(n), 1.0);
+}
+
+// Predicted seconds of a Kick
+double NBodyForceEngine::PredictCost(
+    const unsigned int& engine, const uint64_t& N) const
+{
+    return this->CostModel.coef[engine]*this->EngineWork(engine, N);
+}
+
+// Times every available engine on a sample of the cloud.
+// --> Works on copies, so carriers' forces and velocities stay.
+void NBodyForceEngine::CalibrateForceEngines()
+{
+    auto n_carr = this->Carriers.size();
+    auto n_sample = std::min<uint64_t>(n_carr, FENG_CAL_N);
+    if (n_sample < 2) return;
+
+    auto stride = n_carr / n_sample;
+    CarrierList sample;
+    sample.reserve(n_sample);
+    for (uint64_t i = 0; i < n_sample; ++i)
+        sample.push_back(std::make_shared<Carrier>(*this->Carriers[i*stride]));
+
+    std::swap(this->Carriers, sample);
+    this->calibrating = true;
+
+    std::cout << "Calibrating force engines with " << n_sample \
+        << " carriers..." << std::endl;
+    std::stringstream ss_times;
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine) {
+        if (!this->IsEngineAvailable(engine)) continue;
+
+        // Once to warm up, once to time.
+        this->KickEngine(engine, FP_T(0.0));
+        auto t_start = std::chrono::steady_clock::now();
+        this->KickEngine(engine, FP_T(0.0));
+        auto elapsed = seconds_since(t_start);
+
+        this->CostModel.coef[engine] = \
+            elapsed / this->EngineWork(engine, n_sample);
+        ss_times << " " << ForceEngineName(engine) << " " << elapsed << " s";
+    }
+    std::cout << std::endl << "Force engine times:" << ss_times.str() << std::endl;
+
+    std::swap(this->Carriers, sample);
+    this->calibrating = false;
+    this->CostModel.calibrated = true;
+}
+
+// Cost model to checkpoint
+void NBodyForceEngine::SaveEngineState(CheckpointHeader& header) const
+{
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine)
+        header.cost_coef[engine] = this->CostModel.coef[engine];
+    header.cost_calibrated = this->CostModel.calibrated ? 1 : 0;
+    header.step_engine = this->step_engine;
+    header.step_engine_step = this->step_engine_step;
+}
+
+// Cost model from checkpoint: Auto goes on without calibrating again.
+void NBodyForceEngine::LoadEngineState(const CheckpointHeader& header)
+{
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine)
+        this->CostModel.coef[engine] = header.cost_coef[engine];
+    this->CostModel.calibrated = header.cost_calibrated != 0;
+    this->step_engine = static_cast<unsigned int>(header.step_engine);
+    this->step_engine_step = header.step_engine_step;
+}
+
+// Engine for this step
+// --> Auto: cheapest predicted engine, switching only for a clear gain
+//     so that noise doesn't flip engines every step.
+unsigned int NBodyForceEngine::StepForceEngine()
+{
+    if (this->force_engine != FENG_AUTO) {
+        if (this->force_engine == FENG_NATIVE || \
+            !this->IsEngineAvailable(this->force_engine))
+            this->step_engine = this->NativeForceEngine();
+        else
+            this->step_engine = this->force_engine;
+        return this->step_engine;
+    }
+
+    // Same engine for every Kick of a step.
+    auto step = static_cast<int64_t>(this->sim_step);
+    if (step == this->step_engine_step)
+        return this->step_engine;
+
+    if (this->step_engine_step < 0)
+        this->step_engine = this->NativeForceEngine();
+    this->step_engine_step = step;
+
+    if (!this->CostModel.calibrated)
+        this->CalibrateForceEngines();
+    if (!this->CostModel.calibrated)
+        return this->step_engine;
+
+    auto n_carr = this->Carriers.size();
+
+    auto best = this->step_engine;
+    auto best_cost = this->PredictCost(best, n_carr);
+    auto current_cost = best_cost;
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine) {
+        if (!this->IsEngineAvailable(engine)) continue;
+        auto cost = this->PredictCost(engine, n_carr);
+        if (cost < best_cost) {
+            best = engine;
+            best_cost = cost;
+        }
+    }
+
+    if (best != this->step_engine && best_cost < FENG_SWITCH_GAIN*current_cost) {
+        std::cout << "Force engine: " \
+            << ForceEngineName(this->step_engine) << " -> " \
+            << ForceEngineName(best) << " (N = " << n_carr << ")" << std::endl;
+        this->step_engine = best;
+    }
+
+    return this->step_engine;
+}
+
+const char* NBodyForceEngine::ForceEngineName(const unsigned int& engine)
+{
+    switch (engine) {
+    case FENG_DIRECT: return "Direct";
+    case FENG_TREE: return "Tree";
+    case FENG_MESH: return "Mesh";
+    case FENG_AUTO: return "Auto";
+    }
+    return "Native";
+}
+
+// Set up engine
+void NBodyForceEngine::SetForceEngine(const unsigned int& engine)
+{
+    this->force_engine = engine > FENG_NATIVE ? FENG_NATIVE : engine;
+    this->step_engine_step = -1;
+}
+
+// Set up pair kernel precision of engines
+void NBodyForceEngine::SetForcePrecision(
+    const unsigned int& engines, const unsigned int& prec)
+{
+    if (prec >= PAIR_N_PRECS) {
+        std::cerr << "Error!! Unknown pair kernel precision!!" << std::endl;
+        exit(-1);
+    }
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine)
+        if ((engines >> engine) & 1U) this->force_prec[engine] = prec;
+}
+
+// Constructor
+NBodyForceEngine::NBodyForceEngine() : \
+    force_engine(FENG_NATIVE),
+    step_engine(FENG_DIRECT),
+    step_engine_step(-1),
+    calibrating(false),
+    force_prec{ PAIR_PREC_DOUBLE, PAIR_PREC_DOUBLE, PAIR_PREC_DOUBLE }
+{
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine) {
+        this->CostModel.coef[engine] = 0.0;
+        this->PrecStats[engine] = ForcePrecisionStats{ 0.0, 0.0, 0.0, 0 };
+    }
+    this->CostModel.calibrated = false;
+}
+
+// Engine by name, -1 if unknown.
+int ForceEngineFromStr(const std::string& name)
+{
+    std::string lname = name;
+    std::transform(lname.begin(), lname.end(), lname.begin(), ::tolower);
+    if (lname == "direct") return FENG_DIRECT;
+    else if (lname == "tree") return FENG_TREE;
+    else if (lname == "mesh") return FENG_MESH;
+    else if (lname == "auto") return FENG_AUTO;
+    else if (lname == "native" || lname.empty()) return FENG_NATIVE;
+    return -1;
+}
+
+// Engine bits from comma separated names, -1 if unknown.
+int ForceEngineBitsFromStr(const std::string& names)
+{
+    int bits = 0;
+    std::stringstream ss(names);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        std::string lname = name;
+        std::transform(lname.begin(), lname.end(), lname.begin(), ::tolower);
+        if (lname == "all") bits |= (1 << FENG_N_ENGINES) - 1;
+        else if (lname == "none" || lname.empty()) continue;
+        else {
+            auto engine = ForceEngineFromStr(lname);
+            if (engine < 0 || engine >= static_cast<int>(FENG_N_ENGINES))
+                return -1;
+            bits |= 1 << engine;
+        }
+    }
+    return bits;
+}
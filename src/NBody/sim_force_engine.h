@@ -0,0 +1,173 @@
+/**
+ *
+ * sim_force_engine.h
+ *
+ * Pluggable Coulomb force engines for N-Body simulation
+ *
+ * - Direct: all pairs, O(N^2), exact.
+ * - Tree: Barnes-Hut octree walk (NBody_Octree's own engine).
+ * - Mesh: uniform cell grid over the cloud. Carriers in a cell share
+ *   one interaction list of neighbour cell carriers (exact) and the
+ *   charge monopoles of all other occupied cells.
+ *
+ * Each engine runs its pair kernel in single (offsets from the tile or
+ * group anchor in float, tile sums added up in double) or double
+ * precision. Every FENG_PREC_CHECK_EVERY-th tile of a single precision
+ * engine is also done in double and the difference is reported at the
+ * end of the run.
+ *
+ * In Auto mode the engine is picked once per step from a cost model,
+ * calibrated by timing every engine on a sample of the cloud at the
+ * first Kick and corrected by the measured time of each later Kick.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_force_engine_h__
+#define __sim_force_engine_h__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "CTCForce.h"
+#include "sim_profile.h"
+
+struct CheckpointHeader;
+
+// Force engines
+static const unsigned int FENG_DIRECT = 0;
+static const unsigned int FENG_TREE = 1;
+static const unsigned int FENG_MESH = 2;
+static const unsigned int FENG_AUTO = 3;   // Pick per step by cost model
+static const unsigned int FENG_NATIVE = 4; // Runner's own engine
+static const unsigned int FENG_N_ENGINES = 3;
+
+// Mesh: carriers per cell aimed at and max. cells per axis
+static const fp_t MESH_PER_CELL = 16.0;
+static const uint64_t MESH_MAX_CELLS = 64;
+
+// Non double pair kernel: every n-th tile is checked in double.
+static const uint64_t FENG_PREC_CHECK_EVERY = 64;
+
+// Carriers sampled from the cloud for calibration
+static const uint64_t FENG_CAL_N = 2048;
+
+// Switch engines only if predicted cost drops below this fraction.
+static const double FENG_SWITCH_GAIN = 0.8;
+
+// Weight of a new measurement in cost coefficients
+static const double FENG_COST_EMA = 0.5;
+
+// Cost model: seconds per unit of work of each engine
+// --> Direct: N^2 pairs
+// --> Tree: runner's walk (TreeWork)
+// --> Mesh: N*(near carriers + occupied cells)
+struct ForceCostModel {
+    double coef[FENG_N_ENGINES];
+    bool calibrated;
+};
+
+// Pair kernel error against double kernel, per engine
+struct ForcePrecisionStats {
+    double err_sq;
+    double ref_sq;
+    double err_max;
+    uint64_t tiles;
+};
+
+class NBodyForceEngine : \
+    public virtual Physics::CTCForce, \
+    public virtual NBodyProfile
+{
+public:
+    // Requested engine (FENG_AUTO picks per step)
+    unsigned int force_engine;
+
+    // Engine of current step and the step it was picked for
+    unsigned int step_engine;
+    int64_t step_engine_step;
+
+    ForceCostModel CostModel;
+
+    // Timing engines on a sample (no precision check meanwhile)
+    bool calibrating;
+
+    // Pair kernel precision of each engine (PAIR_PREC_*)
+    unsigned int force_prec[FENG_N_ENGINES];
+
+    ForcePrecisionStats PrecStats[FENG_N_ENGINES];
+
+    // Runner's own engine (FENG_DIRECT or FENG_TREE) and its Kick
+    virtual unsigned int NativeForceEngine() const = 0;
+    virtual int KickNative(const fp_t& delta_t) = 0;
+
+    // Direct and Mesh are always there, Tree only as native engine.
+    bool IsEngineAvailable(const unsigned int& engine) const
+    {
+        return engine == FENG_DIRECT || engine == FENG_MESH || \
+            engine == this->NativeForceEngine();
+    }
+
+    // Coulomb forces added to every carrier
+    void CForceDirect();
+    void CForceMesh();
+
+    bool IsForceFloat(const unsigned int& engine) const
+    { return this->force_prec[engine] == PAIR_PREC_FLOAT; }
+
+    // Pair kernel of an engine on a tile (group) of carriers
+    // --> Call PrepareList first, once per list.
+    void PrepareList(
+        const unsigned int& engine, InteractionList& list, const Loc& anchor);
+    void ForceGroup(
+        const unsigned int& engine, const InteractionList& list,
+        CarrierVector& group, const uint64_t& tile);
+
+    // Engine's precision against double on the tile (thread safe)
+    void CheckForcePrecision(
+        const unsigned int& engine, const InteractionList& list,
+        const CarrierVector& group);
+
+    // Prints error of every non double engine.
+    void ReportForcePrecision() const;
+
+    // Full kick (reset, Coulomb, drift, velocity) with given engine
+    int KickEngine(const unsigned int& engine, const fp_t& delta_t);
+
+    // Engine for this step. Call at the start of Kick.
+    unsigned int StepForceEngine();
+
+    // Cost model
+    double EngineWork(const unsigned int& engine, const uint64_t& N) const;
+    virtual double TreeWork(const double& n) const;
+    double PredictCost(const unsigned int& engine, const uint64_t& N) const;
+    void CalibrateForceEngines();
+
+    // Cost model and engine of the step to and from a checkpoint
+    void SaveEngineState(CheckpointHeader& header) const;
+    void LoadEngineState(const CheckpointHeader& header);
+
+    static const char* ForceEngineName(const unsigned int& engine);
+
+    // Set up engine (FENG_* or FENG_NATIVE)
+    void SetForceEngine(const unsigned int& engine);
+
+    // Set up pair kernel precision (PAIR_PREC_*) of engines (bit per FENG_*)
+    void SetForcePrecision(const unsigned int& engines, const unsigned int& prec);
+
+    // Constructors and Destructors
+    NBodyForceEngine();
+    virtual ~NBodyForceEngine() {;}
+
+};
+
+// Engine by name (Direct, Tree, Mesh, Auto), -1 if unknown.
+int ForceEngineFromStr(const std::string& name);
+
+// Engine bits from comma separated names (Direct, Tree, Mesh, All or
+// None), -1 if unknown.
+int ForceEngineBitsFromStr(const std::string& names);
+
+#endif /* Include guard */
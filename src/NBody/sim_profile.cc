@@ -0,0 +1,315 @@
+/**
+ *
+ * sim_profile.cc
+ *
+ * Phase level instrumentation for N-Body simulation (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "sim_profile.h"
+
+static const char* prof_phase_str[PROF_N_PHASES] = {
+    "MakeTree", "Force", "Drift", "MFP", "Recomb", "Remove", "Output"
+};
+
+/**
+ *
+ * Hardware counters
+ *
+**/
+#if defined(__linux__)
+static int open_perf_counter(const uint32_t& type, const uint64_t& config)
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = type;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // Calling thread, any cpu
+    return static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+bool ProfHWCounters::Open()
+{
+#if defined(__linux__)
+    this->fd_cycles = open_perf_counter(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    this->fd_instr = open_perf_counter(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    if (this->fd_cycles < 0 || this->fd_instr < 0) {
+        this->Close();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProfHWCounters::Close()
+{
+#if defined(__linux__)
+    if (this->fd_cycles >= 0) ::close(this->fd_cycles);
+    if (this->fd_instr >= 0) ::close(this->fd_instr);
+#endif
+    this->fd_cycles = -1;
+    this->fd_instr = -1;
+}
+
+void ProfHWCounters::Read(uint64_t& cycles, uint64_t& instr) const
+{
+    cycles = 0;
+    instr = 0;
+#if defined(__linux__)
+    if (this->fd_cycles < 0) return;
+    if (::read(this->fd_cycles, &cycles, sizeof(cycles)) != sizeof(cycles))
+        cycles = 0;
+    if (::read(this->fd_instr, &instr, sizeof(instr)) != sizeof(instr))
+        instr = 0;
+#endif
+}
+
+/**
+ *
+ * NBodyProfile
+ *
+**/
+// Counters of calling thread
+ProfCounters& NBodyProfile::prof_thread()
+{
+#ifdef _OPENMP
+    size_t ith = static_cast<size_t>(omp_get_thread_num());
+    if (ith < this->prof_counters.size())
+        return this->prof_counters[ith];
+#endif
+    return this->prof_counters[0];
+}
+
+// Phase begin on the main thread
+void NBodyProfile::prof_begin(const ProfPhase& phase)
+{
+    if (!this->prof_on) return;
+
+    if (this->prof_hw.IsOpen()) {
+        this->prof_hw.Read(
+            this->prof_start_cycles[phase], this->prof_start_instr[phase]);
+    }
+    this->prof_start_ns[phase] = this->prof_clock();
+}
+
+// Phase end on the main thread
+void NBodyProfile::prof_end(const ProfPhase& phase)
+{
+    if (!this->prof_on) return;
+
+    auto now = this->prof_clock();
+    auto dur = now - this->prof_start_ns[phase];
+    this->prof_step_ns[phase] += dur;
+
+    if (this->prof_hw.IsOpen()) {
+        uint64_t cycles, instr;
+        this->prof_hw.Read(cycles, instr);
+        this->prof_step_cycles[phase] += cycles - this->prof_start_cycles[phase];
+        this->prof_step_instr[phase] += instr - this->prof_start_instr[phase];
+    }
+
+    auto& events = this->prof_counters[0].events;
+    if (events.size() < PROF_TRACE_MAX) {
+        events.push_back(ProfEvent{
+            static_cast<uint8_t>(phase), 0,
+            this->prof_start_ns[phase], dur,
+            static_cast<int64_t>(this->sim_step) });
+    }
+}
+
+// Worker side: adds a trace event and busy time since start.
+void NBodyProfile::prof_work(
+    ProfCounters& counters, const ProfPhase& phase, const uint64_t& start)
+{
+    if (!this->prof_on) return;
+
+    auto dur = this->prof_clock() - start;
+    counters.busy_ns += dur;
+    if (counters.events.size() < PROF_TRACE_MAX) {
+        counters.events.push_back(ProfEvent{
+            static_cast<uint8_t>(phase), 1, start, dur,
+            static_cast<int64_t>(this->sim_step) });
+    }
+}
+
+// Prepares counters for given number of threads.
+void NBodyProfile::init_prof_counters(const size_t& n_threads)
+{
+    this->prof_counters.resize(n_threads ? n_threads : 1);
+    for (auto& counters : this->prof_counters) counters.clear_step();
+}
+
+// Sums up this step.
+void NBodyProfile::RecordProfile()
+{
+    if (!this->prof_on) return;
+
+    uint64_t pairs = 0, nodes = 0, removed = 0, mfp_ns = 0;
+    uint64_t busy_max = 0, busy_sum = 0;
+    for (auto& counters : this->prof_counters) {
+        pairs += counters.pairs;
+        nodes += counters.nodes;
+        removed += counters.removed;
+        mfp_ns += counters.mfp_ns;
+        busy_sum += counters.busy_ns;
+        if (counters.busy_ns > busy_max) busy_max = counters.busy_ns;
+        counters.clear_step();
+    }
+    this->prof_step_ns[PROF_MFP] = mfp_ns;
+
+    double imbalance = busy_sum ? \
+        static_cast<double>(busy_max) * this->prof_counters.size() / busy_sum : 1.0;
+
+    this->prof_rows << this->sim_step << "," << this->Carriers.size();
+    for (auto i = 0; i < PROF_N_PHASES; ++i)
+        this->prof_rows << "," << this->prof_step_ns[i]*1e-6;
+    this->prof_rows << "," << pairs << "," << nodes << "," << removed \
+        << "," << imbalance;
+    if (this->prof_hw.IsOpen()) {
+        for (auto i = 0; i < PROF_N_PHASES; ++i) {
+            this->prof_rows << "," << this->prof_step_cycles[i] \
+                << "," << this->prof_step_instr[i];
+        }
+    }
+    this->prof_rows << "\n";
+
+    for (auto i = 0; i < PROF_N_PHASES; ++i) {
+        this->prof_step_ns[i] = 0;
+        this->prof_step_cycles[i] = 0;
+        this->prof_step_instr[i] = 0;
+    }
+
+    if (!(++this->prof_n_rows % PROF_FLUSH_STEPS))
+        this->FlushProfile();
+}
+
+// Writes buffered rows.
+int NBodyProfile::FlushProfile()
+{
+    if (!this->prof_on) return 0;
+
+    std::string fname = this->prof_prefix + "_steps.csv";
+    std::ofstream ofs(fname, std::ios::out | std::ios::app);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write profile to: " << fname << std::endl;
+        return -1;
+    }
+    ofs << this->prof_rows.str();
+    ofs.close();
+
+    this->prof_rows.str("");
+    this->prof_rows.clear();
+
+    return 0;
+}
+
+// Writes buffered rows and the Chrome trace file.
+int NBodyProfile::WriteProfile()
+{
+    if (!this->prof_on) return 0;
+    this->FlushProfile();
+
+    std::string fname = this->prof_prefix + "_trace.json";
+    std::ofstream ofs(fname, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write profile to: " << fname << std::endl;
+        return -1;
+    }
+
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (size_t ith = 0; ith < this->prof_counters.size(); ++ith) {
+        for (auto& event : this->prof_counters[ith].events) {
+            if (!first) ofs << ",\n";
+            first = false;
+            ofs << "{\"name\":\"" << prof_phase_str[event.phase] \
+                << (event.worker ? ".work" : "") << "\"," \
+                << "\"cat\":\"" << (event.worker ? "worker" : "phase") << "\"," \
+                << "\"ph\":\"X\",\"pid\":0,\"tid\":" << ith << "," \
+                << "\"ts\":" << event.start*1e-3 << "," \
+                << "\"dur\":" << event.dur*1e-3 << "," \
+                << "\"args\":{\"step\":" << event.step << "}}";
+        }
+    }
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    ofs.close();
+
+    return 0;
+}
+
+// Set up profiling and writes csv legend.
+void NBodyProfile::SetProfile(const std::string& prefix, const bool& use_hw)
+{
+    this->prof_prefix = prefix;
+    this->prof_on = !prefix.empty();
+    if (!this->prof_on) return;
+
+    this->prof_origin = std::chrono::steady_clock::now();
+    this->init_prof_counters(this->processes);
+
+    if (use_hw && !this->prof_hw.Open()) {
+        std::cerr << "Hardware counters are not available " \
+            << "(perf_event_open failed). Timing only." << std::endl;
+    }
+
+    std::string fname = this->prof_prefix + "_steps.csv";
+    std::ofstream ofs(fname, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write profile to: " << fname << std::endl;
+        exit(-1);
+    }
+    ofs << "\"Step\",\"N_carriers\"";
+    for (auto i = 0; i < PROF_N_PHASES; ++i)
+        ofs << ",\"" << prof_phase_str[i] << "(ms)\"";
+    ofs << ",\"Pairs\",\"Nodes\",\"Removed\",\"Imbalance\"";
+    if (this->prof_hw.IsOpen()) {
+        for (auto i = 0; i < PROF_N_PHASES; ++i) {
+            ofs << ",\"" << prof_phase_str[i] << "_cycles\"" \
+                << ",\"" << prof_phase_str[i] << "_instr\"";
+        }
+    }
+    ofs << "\n";
+    ofs.close();
+}
+
+NBodyProfile::NBodyProfile() : \
+    prof_prefix({}),
+    prof_on(false),
+    prof_origin(std::chrono::steady_clock::now()),
+    prof_counters(1),
+    prof_n_rows(0)
+{
+    for (auto i = 0; i < PROF_N_PHASES; ++i) {
+        this->prof_step_ns[i] = 0;
+        this->prof_start_ns[i] = 0;
+        this->prof_step_cycles[i] = 0;
+        this->prof_step_instr[i] = 0;
+        this->prof_start_cycles[i] = 0;
+        this->prof_start_instr[i] = 0;
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ *
+ * sim_profile.h
+ *
+ * Phase level instrumentation for N-Body simulation
+ *
+ * Main phases of a step are timed with begin/end pairs (or
+ * ProfScope), workers keep their own counters and trace events,
+ * and everything is summed up once per step:
+ *
+ * - <prefix>_steps.csv: per step phase times, counters and thread
+ *   imbalance (max/mean busy time of workers).
+ * - <prefix>_trace.json: Chrome trace_event file (chrome://tracing).
+ *
+ * With hardware counters on, cycles and instructions of the main
+ * thread are read via perf_event_open for each phase (Linux only).
+ *
+ * Nothing is measured if profiling is off: every hook returns
+ * right away.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_profile_h__
+#define __sim_profile_h__
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "sim_space.h"
+#include "sim_progress.h"
+
+// Phases of a step
+enum ProfPhase : uint8_t {
+    PROF_MAKETREE = 0,
+    PROF_FORCE,       // tree traversal or direct sum
+    PROF_DRIFT,
+    PROF_MFP,         // summed over workers
+    PROF_RECOMB,
+    PROF_REMOVE,
+    PROF_OUTPUT,
+    PROF_N_PHASES
+};
+
+// Max. number of trace events kept (per thread)
+static const uint64_t PROF_TRACE_MAX = 1 << 20;
+
+// Steps buffered before rows are written to file.
+static const uint64_t PROF_FLUSH_STEPS = 256;
+
+// A complete trace event ("ph": "X")
+struct ProfEvent {
+    uint8_t phase;
+    uint8_t worker;   // worker event or phase event
+    uint64_t start;   // (ns since profiler start)
+    uint64_t dur;     // (ns)
+    int64_t step;
+};
+
+// Per thread counters. Padded to a cache line.
+struct alignas(64) ProfCounters {
+    uint64_t pairs;        // pair interactions
+    uint64_t nodes;        // tree nodes opened
+    uint64_t removed;      // carriers removed
+    uint64_t mfp_ns;       // time in MFP adjustment
+    uint64_t busy_ns;      // time in force/drift work
+    std::vector<ProfEvent> events;
+
+    void clear_step()
+    {
+        pairs = 0; nodes = 0; removed = 0;
+        mfp_ns = 0; busy_ns = 0;
+    }
+
+    ProfCounters() : \
+        pairs(0), nodes(0), removed(0), mfp_ns(0), busy_ns(0)
+    {;}
+};
+
+// Hardware counters of calling thread (cycles, instructions)
+class ProfHWCounters
+{
+private:
+    int fd_cycles;
+    int fd_instr;
+
+public:
+    bool Open();
+    void Close();
+    bool IsOpen() const { return this->fd_cycles >= 0; }
+    void Read(uint64_t& cycles, uint64_t& instr) const;
+
+    ProfHWCounters() : fd_cycles(-1), fd_instr(-1) {;}
+    virtual ~ProfHWCounters() { this->Close(); }
+};
+
+class NBodyProfile : public virtual sim_space
+{
+public:
+    // Output prefix (empty: off)
+    std::string prof_prefix;
+    bool prof_on;
+
+    // Profiler clock origin
+    std::chrono::steady_clock::time_point prof_origin;
+
+    // Phase times of current step (ns) and phase start marks
+    uint64_t prof_step_ns[PROF_N_PHASES];
+    uint64_t prof_start_ns[PROF_N_PHASES];
+
+    // Hardware counters of main thread per phase
+    ProfHWCounters prof_hw;
+    uint64_t prof_step_cycles[PROF_N_PHASES];
+    uint64_t prof_step_instr[PROF_N_PHASES];
+    uint64_t prof_start_cycles[PROF_N_PHASES];
+    uint64_t prof_start_instr[PROF_N_PHASES];
+
+    // Per thread counters and trace events
+    std::vector<ProfCounters> prof_counters;
+
+    // Buffered csv rows
+    std::stringstream prof_rows;
+    uint64_t prof_n_rows;
+
+    // Current time (ns since profiler start), 0 if off.
+    uint64_t prof_clock() const
+    {
+        if (!this->prof_on) return 0;
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - this->prof_origin).count());
+    }
+
+    // Counters of calling thread
+    ProfCounters& prof_thread();
+
+    // Phase begin/end on the main thread
+    void prof_begin(const ProfPhase& phase);
+    void prof_end(const ProfPhase& phase);
+
+    // Worker side: adds a trace event and busy time since start.
+    void prof_work(ProfCounters& counters,
+        const ProfPhase& phase, const uint64_t& start);
+
+    // Adds MFP time since start to calling thread.
+    void prof_add_mfp(const uint64_t& start)
+    {
+        if (!this->prof_on) return;
+        this->prof_thread().mfp_ns += this->prof_clock() - start;
+    }
+
+    // Prepares counters for given number of threads.
+    void init_prof_counters(const size_t& n_threads);
+
+    // Sums up this step. Call once per step.
+    void RecordProfile();
+
+    // Writes buffered rows and the trace file.
+    int FlushProfile();
+    int WriteProfile();
+
+    // Set up profiling
+    void SetProfile(const std::string& prefix, const bool& use_hw);
+
+    // Constructors and Destructors
+    NBodyProfile();
+    virtual ~NBodyProfile() {;}
+
+};
+
+// Times a phase until end of scope.
+class ProfScope
+{
+private:
+    NBodyProfile* prof;
+    ProfPhase phase;
+
+public:
+    ProfScope(NBodyProfile* p, const ProfPhase& ph) : prof(p), phase(ph)
+    { this->prof->prof_begin(this->phase); }
+    virtual ~ProfScope()
+    { this->prof->prof_end(this->phase); }
+};
+
+#endif /* Include guard */
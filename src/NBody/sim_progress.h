@@ -36,6 +36,9 @@ class SimProgress
 public:
     fp_t delta_t; // simulation step time in seconds.
     fp_t elapsed_time; // elapsed time in seconds.
+#ifdef __COMPENSATED__
+    fp_t elapsed_time_c; // Kahan term of elapsed_time
+#endif
     fp_int_t sim_step; // Current simulation step
 
     bool gen_carr_log; // Generate carrier log or not.
@@ -72,6 +75,16 @@ public:
         this->forced_delta_t = true;
     }
 
+    // Advance elapsed time by a step
+    void AdvanceTime(const fp_t& dt)
+    {
+#ifdef __COMPENSATED__
+        fp_kahan_add<fp_t>(this->elapsed_time, this->elapsed_time_c, dt);
+#else
+        this->elapsed_time += dt;
+#endif
+    }
+
     // Set stability & accuracy constant
     void SetSnAConst(const fp_t& new_nu)
     { this->nu = new_nu; }
@@ -84,6 +97,9 @@ public:
     SimProgress() : \
         delta_t(static_cast<fp_t>(0.0)),
     	elapsed_time(static_cast<fp_t>(0.0)),
+#ifdef __COMPENSATED__
+        elapsed_time_c(static_cast<fp_t>(0.0)),
+#endif
         sim_algorithm_str(std::string({})),
         gen_carr_log(true),
         forced_delta_t(false),
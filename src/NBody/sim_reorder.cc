@@ -0,0 +1,127 @@
+/**
+ *
+ * sim_reorder.cc
+ *
+ * Space filling curve (Morton) ordering of carrier storage
+ * (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+#include "sim_reorder.h"
+
+// Spreads the lower 21 bits of v to every third bit.
+static uint64_t morton_spread(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+// Morton keys of carriers over the cloud bounding box
+void NBodyReorder::morton_keys(std::vector<uint64_t>& keys) const
+{
+    keys.resize(this->Carriers.size());
+    if (this->Carriers.empty()) return;
+
+    auto c_min = this->Carriers.front()->GetPos();
+    auto c_max = c_min;
+    for (auto& carrier : this->Carriers) {
+        auto pos = carrier->GetPos();
+        c_min = Loc{
+            fp_min<fp_t>(c_min.x, pos.x),
+            fp_min<fp_t>(c_min.y, pos.y),
+            fp_min<fp_t>(c_min.z, pos.z) };
+        c_max = Loc{
+            fp_max<fp_t>(c_max.x, pos.x),
+            fp_max<fp_t>(c_max.y, pos.y),
+            fp_max<fp_t>(c_max.z, pos.z) };
+    }
+
+    // Same scale on every axis: cells stay cubic.
+    auto side = fp_max<fp_t>(
+        c_max.x - c_min.x, c_max.y - c_min.y, c_max.z - c_min.z);
+    fp_t max_cell = static_cast<fp_t>((1ULL << MORTON_BITS) - 1);
+    fp_t scale = side > FP_T(0.0) ? max_cell / side : FP_T(0.0);
+
+    for (size_t i = 0; i < this->Carriers.size(); ++i) {
+        auto pos = this->Carriers[i]->GetPos();
+        auto ix = static_cast<uint64_t>((pos.x - c_min.x)*scale);
+        auto iy = static_cast<uint64_t>((pos.y - c_min.y)*scale);
+        auto iz = static_cast<uint64_t>((pos.z - c_min.z)*scale);
+        keys[i] = morton_spread(ix) | \
+            morton_spread(iy) << 1 | morton_spread(iz) << 2;
+    }
+}
+
+// Fraction of neighbours out of key order
+fp_t NBodyReorder::key_disorder(const std::vector<uint64_t>& keys)
+{
+    if (keys.size() < 2) return FP_T(0.0);
+
+    uint64_t n_out = 0;
+    for (size_t i = 1; i < keys.size(); ++i)
+        if (keys[i] < keys[i - 1]) ++n_out;
+
+    return static_cast<fp_t>(n_out) / static_cast<fp_t>(keys.size() - 1);
+}
+
+// Sorts carriers by key into fresh storage.
+// --> Copies are allocated in order, so they end up close in memory.
+void NBodyReorder::ReorderCarriers(const std::vector<uint64_t>& keys)
+{
+    std::vector<size_t> order(this->Carriers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&keys](const size_t& a, const size_t& b) { return keys[a] < keys[b]; });
+
+    CarrierList sorted;
+    sorted.reserve(this->Carriers.size());
+    for (auto& i : order)
+        sorted.push_back(std::make_shared<Carrier>(*this->Carriers[i]));
+
+    this->Carriers = std::move(sorted);
+    ++this->reorder_count;
+}
+
+// Sorts carriers if it's due.
+int NBodyReorder::ReorderIfDue()
+{
+    if (this->Carriers.size() < 2) return 0;
+
+    bool every_due = this->reorder_every && \
+        !(this->sim_step % this->reorder_every);
+    bool check_due = this->reorder_disorder > FP_T(0.0) && \
+        !(this->sim_step % REORDER_CHECK_STEPS);
+    if (!every_due && !check_due) return 0;
+
+    std::vector<uint64_t> keys;
+    this->morton_keys(keys);
+    if (!every_due && \
+        this->key_disorder(keys) <= this->reorder_disorder)
+        return 0;
+
+    this->ReorderCarriers(keys);
+    return 1;
+}
+
+// Set up sort interval and disorder threshold
+void NBodyReorder::SetReorder(const uint64_t& every, const fp_t& disorder)
+{
+    if (disorder < FP_T(0.0) || disorder > FP_T(1.0)) {
+        std::cerr << "Error!! Reorder disorder threshold must be in [0, 1]!!" \
+            << std::endl;
+        exit(-1);
+    }
+    this->reorder_every = every;
+    this->reorder_disorder = disorder;
+}
@@ -0,0 +1,78 @@
+/**
+ *
+ * sim_reorder.h
+ *
+ * Space filling curve (Morton) ordering of carrier storage
+ *
+ * Carriers come in the order of the input file, so neighbours in
+ * space are far apart in memory and every engine, the drift and the
+ * output pay for it in cache misses. Here the carrier list is sorted
+ * by Morton key over the cloud bounding box and the carriers are
+ * copied into fresh, consecutively allocated storage.
+ *
+ * Sorting happens every reorder_every steps, or whenever the fraction
+ * of neighbours out of key order exceeds reorder_disorder (checked
+ * every REORDER_CHECK_STEPS steps). Carrier indices (IDs) stay with
+ * the carriers, so the output is unaffected. Both are off by default.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_reorder_h__
+#define __sim_reorder_h__
+
+#include <vector>
+#include <cstdint>
+
+#include "sim_space.h"
+
+// Default disorder threshold (0: off)
+// --> Off: on the smoke input sorting costs more than it saves.
+static const fp_t REORDER_DISORDER_DEF = FP_T(0.0);
+
+// Steps between disorder checks
+static const uint64_t REORDER_CHECK_STEPS = 8;
+
+// Bits per axis of Morton keys
+static const unsigned int MORTON_BITS = 21;
+
+class NBodyReorder : public virtual sim_space
+{
+public:
+    // Sort every n steps (0: off)
+    uint64_t reorder_every;
+
+    // Sort if fraction of neighbours out of order exceeds (0: off)
+    fp_t reorder_disorder;
+
+    // Number of sorts so far
+    uint64_t reorder_count;
+
+    // Morton keys of carriers over the cloud bounding box
+    void morton_keys(std::vector<uint64_t>& keys) const;
+
+    // Fraction of neighbours out of key order
+    static fp_t key_disorder(const std::vector<uint64_t>& keys);
+
+    // Sorts carriers by key into fresh storage.
+    void ReorderCarriers(const std::vector<uint64_t>& keys);
+
+    // Sorts carriers if it's due. Call between steps.
+    // Returns 1 if sorted.
+    int ReorderIfDue();
+
+    // Set up sort interval and disorder threshold (0: off)
+    void SetReorder(const uint64_t& every, const fp_t& disorder);
+
+    // Constructors and Destructors
+    NBodyReorder() : \
+        reorder_every(0),
+        reorder_disorder(REORDER_DISORDER_DEF),
+        reorder_count(0)
+    {;}
+    virtual ~NBodyReorder() {;}
+
+};
+
+#endif /* Include guard */
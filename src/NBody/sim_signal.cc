@@ -0,0 +1,187 @@
+/**
+ *
+ * sim_signal.cc
+ *
+ * Induced current (Shockley-Ramo) accumulator (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include "sim_signal.h"
+
+// Adds induced charge of carriers drifting for tau.
+void NBodySignal::AccumulateSignal(const fp_t& tau)
+{
+    if (this->signal_file.empty()) return;
+
+    // Electrode gap (um), velocities are in um/s.
+    fp_t thickness = \
+        this->silicon_dimension->z_end - this->silicon_dimension->z_start;
+
+    fp_t vz_elec = FP_T(0.0);
+    fp_t vz_hole = FP_T(0.0);
+    for (auto& carrier : this->Carriers) {
+        fp_t vz = carrier->GetVel().z;
+        if (carrier->GetTypeI() == CARR_T_ELECTRON) vz_elec += vz;
+        else vz_hole += vz;
+    }
+
+    // i = -q*v_z/d
+    this->signal_q_elec -= q_e*vz_elec/thickness*tau;
+    this->signal_q_hole -= q_h*vz_hole/thickness*tau;
+
+    fp_t t0 = this->elapsed_time + this->signal_tau;
+    this->accumulate_ghosts(t0, t0 + tau);
+    this->signal_tau += tau;
+}
+
+// Adds induced charge of ghosts between t0 and t1.
+void NBodySignal::accumulate_ghosts(const fp_t& t0, const fp_t& t1)
+{
+    if (this->signal_ghosts.empty()) return;
+
+    fp_t thickness = \
+        this->silicon_dimension->z_end - this->silicon_dimension->z_start;
+
+    for (auto& ghost : this->signal_ghosts) {
+        fp_t overlap = \
+            std::min(t1, ghost.t_end) - std::max(t0, ghost.t_start);
+        if (overlap <= FP_T(0.0)) continue;
+
+        if (ghost.type == CARR_T_ELECTRON)
+            this->signal_q_elec -= q_e*ghost.vz/thickness*overlap;
+        else
+            this->signal_q_hole -= q_h*ghost.vz/thickness*overlap;
+    }
+
+    this->signal_ghosts.erase(
+        std::remove_if(
+            this->signal_ghosts.begin(), this->signal_ghosts.end(),
+            [&t1](const SignalGhost& ghost) { return ghost.t_end <= t1; }),
+        this->signal_ghosts.end());
+}
+
+// Adds a ghost
+void NBodySignal::AddSignalGhost(
+    const uint8_t& type, const fp_t& vz,
+    const fp_t& t_start, const fp_t& t_end)
+{
+#pragma omp critical (signal_ghost)
+    this->signal_ghosts.push_back(SignalGhost{ type, vz, t_start, t_end });
+}
+
+// Records rows until the last ghost is collected.
+void NBodySignal::DrainSignal()
+{
+    if (this->signal_file.empty() || this->signal_ghosts.empty()) return;
+
+    fp_t t_now = this->elapsed_time + this->signal_tau;
+    fp_t t_last = t_now;
+    for (auto& ghost : this->signal_ghosts)
+        t_last = std::max(t_last, ghost.t_end);
+
+    if (t_last <= t_now) {
+        this->signal_ghosts.clear();
+        return;
+    }
+
+    // Last delta_t unless it gives too many rows.
+    fp_t tau = (t_last - t_now)/static_cast<fp_t>(SIG_DRAIN_MAX_ROWS);
+    if (this->delta_t > tau)
+        tau = std::min(this->delta_t, t_last - t_now);
+
+    // Rows are stamped with step and time, restored afterwards.
+    auto step = this->sim_step;
+    auto time = this->elapsed_time;
+    while (!this->signal_ghosts.empty()) {
+        t_now = this->elapsed_time + this->signal_tau;
+        this->accumulate_ghosts(t_now, t_now + tau);
+        this->signal_tau += tau;
+        this->RecordSignal();
+        ++this->sim_step;
+        this->elapsed_time += tau;
+    }
+    this->sim_step = step;
+    this->elapsed_time = time;
+}
+
+// Records average current of this step.
+void NBodySignal::RecordSignal()
+{
+    if (this->signal_file.empty()) return;
+
+    fp_t i_elec = FP_T(0.0);
+    fp_t i_hole = FP_T(0.0);
+    if (this->signal_tau > FP_T(0.0)) {
+        i_elec = this->signal_q_elec / this->signal_tau;
+        i_hole = this->signal_q_hole / this->signal_tau;
+    }
+    this->signal_q_total += this->signal_q_elec + this->signal_q_hole;
+
+    this->signal_rows \
+        << this->sim_step << "," \
+        << this->elapsed_time + this->signal_tau << "," \
+        << this->signal_tau << "," \
+        << i_elec << "," \
+        << i_hole << "," \
+        << i_elec + i_hole << "," \
+        << this->signal_q_total << "\n";
+
+    this->signal_q_elec = FP_T(0.0);
+    this->signal_q_hole = FP_T(0.0);
+    this->signal_tau = FP_T(0.0);
+
+    if (!(++this->signal_n_rows % SIG_FLUSH_STEPS))
+        this->FlushSignal();
+}
+
+// Writes buffered rows to file.
+int NBodySignal::FlushSignal()
+{
+    if (this->signal_file.empty()) return 0;
+
+    std::ofstream ofs(this->signal_file, std::ios::out | std::ios::app);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write current to: " \
+            << this->signal_file << std::endl;
+        return -1;
+    }
+    ofs << this->signal_rows.str();
+    ofs.close();
+
+    this->signal_rows.str("");
+    this->signal_rows.clear();
+
+    return 0;
+}
+
+// Set up current output file and writes legend.
+void NBodySignal::SetSignalFile(const std::string& fname, const bool& append)
+{
+    this->signal_file = fname;
+    if (this->signal_file.empty()) return;
+
+    this->signal_rows << std::scientific << std::setprecision(9);
+
+    // Restart appends to an existing file (cut back by the checkpoint)
+    if (append) {
+        std::ifstream ifs(this->signal_file);
+        if (ifs.is_open()) return;
+    }
+
+    std::ofstream ofs(this->signal_file, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write current to: " \
+            << this->signal_file << std::endl;
+        exit(-1);
+    }
+    ofs << "\"Step\",\"Time(s)\",\"dt(s)\"," \
+        << "\"I_elec(A)\",\"I_hole(A)\",\"I(A)\",\"Q(C)\"\n";
+    ofs.close();
+}
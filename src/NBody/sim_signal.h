@@ -0,0 +1,115 @@
+/**
+ *
+ * sim_signal.h
+ *
+ * Induced current (Shockley-Ramo) accumulator for N-Body simulation
+ *
+ * For the parallel plate geometry of DriftForce, the weighting
+ * field of the z_end electrode is uniform, -1/d along z. A carrier
+ * with charge q and velocity v induces i = -q*v_z/d on it, and the
+ * z_start electrode gets the opposite.
+ *
+ * Each Drift adds sum(i)*tau of the moving carriers, and once per
+ * step the average current over the step goes to a small csv file,
+ * so the signal doesn't need the full carrier log.
+ *
+ * Carriers collected ahead of time (NBodyFastForward) leave a ghost
+ * that keeps inducing current until its collection time.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_signal_h__
+#define __sim_signal_h__
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+
+#include "sim_space.h"
+#include "sim_progress.h"
+
+// Steps buffered before current rows are written to file.
+static const uint64_t SIG_FLUSH_STEPS = 256;
+
+// Max. rows written for ghosts left at the end of run.
+static const uint64_t SIG_DRAIN_MAX_ROWS = 10000;
+
+// A carrier removed before it reached the electrode: drifts with
+// constant v_z (um/s) from t_start to t_end (s).
+struct SignalGhost {
+    uint8_t type;
+    fp_t vz;
+    fp_t t_start;
+    fp_t t_end;
+};
+
+class NBodySignal : public virtual sim_space
+{
+public:
+    // Current output file (empty: off)
+    std::string signal_file;
+
+    // Induced charge on z_end electrode during current step (C),
+    // electron and hole parts.
+    fp_t signal_q_elec;
+    fp_t signal_q_hole;
+
+    // Drift time accumulated during current step (s)
+    fp_t signal_tau;
+
+    // Total induced charge so far (C)
+    fp_t signal_q_total;
+
+    // Buffered csv rows
+    std::stringstream signal_rows;
+    uint64_t signal_n_rows;
+
+    // Carriers still drifting outside of Carriers
+    std::vector<SignalGhost> signal_ghosts;
+
+    // Adds induced charge of carriers drifting for tau.
+    // Call before carriers are moved.
+    void AccumulateSignal(const fp_t& tau);
+
+    // Adds induced charge of ghosts between t0 and t1, drops finished.
+    void accumulate_ghosts(const fp_t& t0, const fp_t& t1);
+
+    // Adds a ghost (thread safe)
+    void AddSignalGhost(
+        const uint8_t& type, const fp_t& vz,
+        const fp_t& t_start, const fp_t& t_end);
+
+    // Records rows until the last ghost is collected. Call at the end.
+    void DrainSignal();
+
+    // Records average current of this step. Call once per step.
+    void RecordSignal();
+
+    // Writes buffered rows to file.
+    int FlushSignal();
+
+    // Set up current output file
+    // --> append: keep rows of the run being restarted.
+    void SetSignalFile(const std::string& fname, const bool& append = false);
+
+    bool IsSignalOn() const
+    { return !this->signal_file.empty(); }
+
+    // Constructors and Destructors
+    NBodySignal() : \
+        signal_file({}),
+        signal_q_elec(FP_T(0.0)),
+        signal_q_hole(FP_T(0.0)),
+        signal_tau(FP_T(0.0)),
+        signal_q_total(FP_T(0.0)),
+        signal_n_rows(0),
+        signal_ghosts({})
+    {;}
+    virtual ~NBodySignal() {;}
+
+};
+
+#endif /* Include guard */
@@ -0,0 +1,247 @@
+/**
+ *
+ * sim_stats.cc
+ *
+ * Streaming statistics for N-Body simulation (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+#include "sim_stats.h"
+
+using std::sqrt;
+
+// Centroid (um)
+Loc CloudMoments::centroid() const
+{
+    if (!n) return Loc{ 0, 0, 0 };
+    return this->sum / static_cast<fp_t>(n);
+}
+
+// RMS distance from centroid (um)
+fp_t CloudMoments::rms() const
+{
+    if (!n) return FP_T(0.0);
+    auto c = this->centroid();
+    auto nf = static_cast<fp_t>(n);
+    fp_t var = \
+        this->sum_sq.x/nf - c.x*c.x + \
+        this->sum_sq.y/nf - c.y*c.y + \
+        this->sum_sq.z/nf - c.z*c.z;
+    return var > FP_T(0.0) ? sqrt(var) : FP_T(0.0);
+}
+
+// Prepares partials for current number of threads.
+void NBodyStats::init_stats_partials(const size_t& n_threads)
+{
+    if (this->stats_partials.size() != n_threads)
+        this->stats_partials.resize(n_threads);
+    for (auto& partial : this->stats_partials) partial.clear();
+}
+
+// Adds carrier to a partial
+void NBodyStats::stats_add(
+    StatsPartial& partial, const Carrier& carrier, const int& status,
+    const fp_t& t_collect)
+{
+    if (status == CARR_STAY) {
+        partial.moments[carrier.GetTypeI()].add(carrier.GetPos());
+    }
+    else if (status == CARR_COLLECTED) {
+        auto pos = carrier.GetPos();
+        uint8_t electrode = \
+            (pos.z < this->silicon_dimension->z_start) ? \
+            STAT_ELECTRODE_BOTTOM : STAT_ELECTRODE_TOP;
+        partial.collected.push_back(
+            CollectedSample{ electrode, carrier.GetTypeI(), pos, t_collect });
+    }
+}
+
+// Adds a value to histogram
+void NBodyStats::hist_add(
+    std::vector<uint64_t>& hist, const fp_t& val, const fp_t& bin)
+{
+    uint64_t ibin = 0;
+    if (val > FP_T(0.0))
+        ibin = static_cast<uint64_t>(static_cast<double>(val/bin));
+    if (ibin >= STAT_MAX_BINS) ibin = STAT_MAX_BINS - 1;
+    if (ibin >= hist.size()) hist.resize(ibin + 1, 0);
+    ++hist[ibin];
+}
+
+// Merges partials after a drift of tau.
+void NBodyStats::MergeStats(const fp_t& tau)
+{
+    if (this->stats_prefix.empty()) return;
+
+    this->cloud[CARR_T_ELECTRON].clear();
+    this->cloud[CARR_T_HOLE].clear();
+    for (auto& partial : this->stats_partials) {
+        this->cloud[CARR_T_ELECTRON].merge(partial.moments[CARR_T_ELECTRON]);
+        this->cloud[CARR_T_HOLE].merge(partial.moments[CARR_T_HOLE]);
+    }
+
+    // First snapshot sets the radial reference.
+    if (!this->has_ref) {
+        CloudMoments all = this->cloud[CARR_T_ELECTRON];
+        all.merge(this->cloud[CARR_T_HOLE]);
+        auto c = all.centroid();
+        this->ref_x = c.x;
+        this->ref_y = c.y;
+        this->has_ref = true;
+    }
+
+    this->stats_step_tau += tau;
+    fp_t t_collect = this->elapsed_time + this->stats_step_tau;
+
+    for (auto& partial : this->stats_partials) {
+        for (auto& sample : partial.collected) {
+            fp_t dx = sample.pos.x - this->ref_x;
+            fp_t dy = sample.pos.y - this->ref_y;
+            this->hist_add(
+                this->hist_time[sample.electrode][sample.type],
+                (sample.time < FP_T(0.0)) ? t_collect : sample.time,
+                this->stats_t_bin);
+            this->hist_add(
+                this->hist_radius[sample.electrode][sample.type],
+                sqrt(dx*dx + dy*dy), this->stats_r_bin);
+        }
+    }
+}
+
+// Records moments of this step.
+void NBodyStats::RecordStats()
+{
+    if (this->stats_prefix.empty()) return;
+
+    auto& elec = this->cloud[CARR_T_ELECTRON];
+    auto& hole = this->cloud[CARR_T_HOLE];
+    auto c_e = elec.centroid();
+    auto c_h = hole.centroid();
+    auto rms_e = elec.rms();
+    auto rms_h = hole.rms();
+    fp_t sep = (elec.n && hole.n) ? c_e.dist(c_h) : FP_T(0.0);
+    fp_t t_now = this->elapsed_time + this->stats_step_tau;
+
+    if (this->onset_step < 0 && elec.n && hole.n && sep > rms_e + rms_h) {
+        this->onset_step = this->sim_step;
+        this->onset_time = t_now;
+    }
+
+    this->stats_rows \
+        << this->sim_step << "," << t_now << "," \
+        << elec.n << "," << hole.n << "," \
+        << c_e.x << "," << c_e.y << "," << c_e.z << "," << rms_e << "," \
+        << c_h.x << "," << c_h.y << "," << c_h.z << "," << rms_h << "," \
+        << sep << "\n";
+
+    this->stats_step_tau = FP_T(0.0);
+
+    if (!(++this->stats_n_rows % STAT_FLUSH_STEPS))
+        this->FlushStats();
+}
+
+// Writes buffered moment rows.
+int NBodyStats::FlushStats()
+{
+    if (this->stats_prefix.empty()) return 0;
+
+    std::string fname = this->stats_prefix + "_moments.csv";
+    std::ofstream ofs(fname, std::ios::out | std::ios::app);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write statistics to: " << fname << std::endl;
+        return -1;
+    }
+    ofs << this->stats_rows.str();
+    ofs.close();
+
+    this->stats_rows.str("");
+    this->stats_rows.clear();
+
+    return 0;
+}
+
+// Writes histograms and plasma delay onset.
+int NBodyStats::WriteStatsSummary()
+{
+    if (this->stats_prefix.empty()) return 0;
+    this->FlushStats();
+
+    std::string fname = this->stats_prefix + "_hist.csv";
+    std::ofstream ofs(fname, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write statistics to: " << fname << std::endl;
+        return -1;
+    }
+
+    const char* electrode_str[2] = { "Bottom", "Top" };
+    const char* type_str[2] = { "Electron", "Hole" };
+
+    ofs << std::scientific << std::setprecision(9);
+    ofs << "# Plasma delay onset step: " << this->onset_step << "\n";
+    ofs << "# Plasma delay onset time (s): " << this->onset_time << "\n";
+    ofs << "# Radial reference x, y (um): " \
+        << this->ref_x << ", " << this->ref_y << "\n";
+    ofs << "\"Kind\",\"Electrode\",\"Type\",\"Low\",\"High\",\"Count\"\n";
+
+    for (auto e = 0; e < 2; ++e) {
+        for (auto t = 0; t < 2; ++t) {
+            auto& h_t = this->hist_time[e][t];
+            for (uint64_t i = 0; i < h_t.size(); ++i) {
+                if (!h_t[i]) continue;
+                ofs << "Time," << electrode_str[e] << "," << type_str[t] << "," \
+                    << this->stats_t_bin*i << "," << this->stats_t_bin*(i+1) << "," \
+                    << h_t[i] << "\n";
+            }
+            auto& h_r = this->hist_radius[e][t];
+            for (uint64_t i = 0; i < h_r.size(); ++i) {
+                if (!h_r[i]) continue;
+                ofs << "Radius," << electrode_str[e] << "," << type_str[t] << "," \
+                    << this->stats_r_bin*i << "," << this->stats_r_bin*(i+1) << "," \
+                    << h_r[i] << "\n";
+            }
+        }
+    }
+    ofs.close();
+
+    return 0;
+}
+
+// Set up statistics output and writes legend.
+void NBodyStats::SetStats(
+    const std::string& prefix,
+    const fp_t& t_bin, const fp_t& r_bin,
+    const bool& append)
+{
+    this->stats_prefix = prefix;
+    if (t_bin > FP_T(0.0)) this->stats_t_bin = t_bin;
+    if (r_bin > FP_T(0.0)) this->stats_r_bin = r_bin;
+    if (this->stats_prefix.empty()) return;
+
+    this->stats_rows << std::scientific << std::setprecision(9);
+
+    std::string fname = this->stats_prefix + "_moments.csv";
+
+    // Restart appends to an existing file (cut back by the checkpoint)
+    if (append) {
+        std::ifstream ifs(fname);
+        if (ifs.is_open()) return;
+    }
+
+    std::ofstream ofs(fname, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write statistics to: " << fname << std::endl;
+        exit(-1);
+    }
+    ofs << "\"Step\",\"Time(s)\",\"N_elec\",\"N_hole\"," \
+        << "\"Cx_elec(um)\",\"Cy_elec(um)\",\"Cz_elec(um)\",\"RMS_elec(um)\"," \
+        << "\"Cx_hole(um)\",\"Cy_hole(um)\",\"Cz_hole(um)\",\"RMS_hole(um)\"," \
+        << "\"Separation(um)\"\n";
+    ofs.close();
+}
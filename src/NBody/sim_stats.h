@@ -0,0 +1,180 @@
+/**
+ *
+ * sim_stats.h
+ *
+ * Streaming statistics for N-Body simulation
+ *
+ * Accumulated in the drift pass with one partial per thread, merged
+ * after each drift:
+ *
+ * - Collection time and radial position histograms per electrode
+ *   and carrier type.
+ * - Cloud centroid and RMS spread per carrier type, every step.
+ * - Plasma delay onset: first step where electron and hole
+ *   centroids are farther apart than the sum of their spreads.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __sim_stats_h__
+#define __sim_stats_h__
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+
+#include "sim_space.h"
+#include "sim_progress.h"
+
+// Electrodes
+static const unsigned int STAT_ELECTRODE_BOTTOM = 0; // z_start
+static const unsigned int STAT_ELECTRODE_TOP = 1;    // z_end
+
+// Default histogram bin widths
+static const fp_t STAT_T_BIN_DEF = 1e-12; // (s)
+static const fp_t STAT_R_BIN_DEF = 1.0;   // (um)
+
+// Max. bins per histogram. The last bin takes the overflow.
+static const uint64_t STAT_MAX_BINS = 65536;
+
+// Steps buffered before moment rows are written to file.
+static const uint64_t STAT_FLUSH_STEPS = 256;
+
+// Sums for centroid and spread of a carrier type
+struct CloudMoments {
+    uint64_t n;
+    Loc sum;
+    Loc sum_sq;
+
+    void add(const Loc& pos)
+    {
+        ++n;
+        sum += pos;
+        sum_sq += Loc{ pos.x*pos.x, pos.y*pos.y, pos.z*pos.z };
+    }
+    void merge(const CloudMoments& other)
+    {
+        n += other.n;
+        sum += other.sum;
+        sum_sq += other.sum_sq;
+    }
+    void clear()
+    {
+        n = 0;
+        sum = Loc{ 0, 0, 0 };
+        sum_sq = Loc{ 0, 0, 0 };
+    }
+
+    Loc centroid() const;
+    fp_t rms() const;
+
+    CloudMoments() : n(0), sum({0, 0, 0}), sum_sq({0, 0, 0}) {;}
+};
+
+// A collected carrier (negative time: known at merge)
+struct CollectedSample {
+    uint8_t electrode;
+    uint8_t type;
+    Loc pos;
+    fp_t time;
+};
+
+// Per thread partial of a drift pass
+struct StatsPartial {
+    CloudMoments moments[2];              // by carrier type
+    std::vector<CollectedSample> collected;
+
+    void clear()
+    {
+        moments[CARR_T_ELECTRON].clear();
+        moments[CARR_T_HOLE].clear();
+        collected.clear();
+    }
+};
+
+class NBodyStats : public virtual sim_space
+{
+public:
+    // Output prefix (empty: off)
+    std::string stats_prefix;
+
+    // Histogram bin widths
+    fp_t stats_t_bin;
+    fp_t stats_r_bin;
+
+    // Partials, one per thread
+    std::vector<StatsPartial> stats_partials;
+
+    // Histograms [electrode][carrier type]
+    std::vector<uint64_t> hist_time[2][2];
+    std::vector<uint64_t> hist_radius[2][2];
+
+    // Moments after the last drift
+    CloudMoments cloud[2];
+
+    // Radial reference (initial centroid in x-y)
+    bool has_ref;
+    fp_t ref_x, ref_y;
+
+    // Drift time elapsed within current step (s)
+    fp_t stats_step_tau;
+
+    // Plasma delay onset (s), negative until found.
+    fp_t onset_time;
+    fp_int_t onset_step;
+
+    // Buffered moment rows
+    std::stringstream stats_rows;
+    uint64_t stats_n_rows;
+
+    bool IsStatsOn() const
+    { return !this->stats_prefix.empty(); }
+
+    // Prepares partials for current number of threads.
+    void init_stats_partials(const size_t& n_threads);
+
+    // Adds carrier to a partial (drift pass, thread safe)
+    // t_collect: collection time if not at the end of this drift
+    void stats_add(
+        StatsPartial& partial, const Carrier& carrier, const int& status,
+        const fp_t& t_collect = FP_T(-1.0));
+
+    // Merges partials after a drift of tau.
+    void MergeStats(const fp_t& tau);
+
+    // Records moments of this step. Call once per step.
+    void RecordStats();
+
+    // Writes buffered moments and final histograms.
+    int FlushStats();
+    int WriteStatsSummary();
+
+    // Set up statistics output
+    // --> append: keep moment rows of the run being restarted.
+    void SetStats(
+        const std::string& prefix,
+        const fp_t& t_bin, const fp_t& r_bin,
+        const bool& append = false);
+
+    // Constructors and Destructors
+    NBodyStats() : \
+        stats_prefix({}),
+        stats_t_bin(STAT_T_BIN_DEF),
+        stats_r_bin(STAT_R_BIN_DEF),
+        has_ref(false),
+        ref_x(FP_T(0.0)), ref_y(FP_T(0.0)),
+        stats_step_tau(FP_T(0.0)),
+        onset_time(FP_T(-1.0)),
+        onset_step(-1),
+        stats_n_rows(0)
+    {;}
+    virtual ~NBodyStats() {;}
+
+private:
+    void hist_add(std::vector<uint64_t>& hist, const fp_t& val, const fp_t& bin);
+
+};
+
+#endif /* Include guard */
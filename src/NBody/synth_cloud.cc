@@ -0,0 +1,192 @@
+/**
+ *
+ * synth_cloud.cc
+ *
+ * Synthetic carrier clouds for benchmarks and scaling studies
+ * (implementation)
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <iostream>
+
+#include "physical_constants.h"
+#include "untar.h"
+#include "synth_cloud.h"
+
+// Member name of the csv inside synthetic tarballs
+static const char* SYNTH_CSV_NAME = "./synthetic_cloud.csv";
+
+// Gaussian blob of n deposits around center with spread sigma (um)
+std::vector<Loc> SynthGaussianDeposits(
+    const uint64_t& n,
+    const Loc& center,
+    const fp_t& sigma,
+    const uint64_t& seed)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> dist(0.0, static_cast<double>(sigma));
+
+    std::vector<Loc> deposits;
+    deposits.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        Loc pos = center;
+        pos += Loc{
+            static_cast<fp_t>(dist(rng)),
+            static_cast<fp_t>(dist(rng)),
+            static_cast<fp_t>(dist(rng)) };
+        deposits.push_back(pos);
+    }
+
+    return deposits;
+}
+
+// Keeps a deposit inside box
+static Loc clamp_to_box(const Loc& pos, const Box& box)
+{
+    return Loc{
+        std::min(std::max(pos.x, box.x_start), box.x_end),
+        std::min(std::max(pos.y, box.y_start), box.y_end),
+        std::min(std::max(pos.z, box.z_start), box.z_end) };
+}
+
+// Deposits of given spec, clamped into spec.box
+std::vector<Loc> SynthDeposits(const SynthCloudSpec& spec)
+{
+    std::mt19937_64 rng(spec.seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    auto sigma = static_cast<double>(spec.sigma);
+    auto& box = spec.box;
+
+    std::vector<Loc> deposits;
+    deposits.reserve(spec.n_deposits);
+
+    switch (spec.geometry) {
+    case SYNTH_POINT:
+        deposits.assign(spec.n_deposits, spec.center);
+        break;
+
+    case SYNTH_LINE:
+        // Track through the whole sensor thickness
+        for (uint64_t i = 0; i < spec.n_deposits; ++i) {
+            deposits.push_back(Loc{
+                spec.center.x + static_cast<fp_t>(sigma*gauss(rng)),
+                spec.center.y + static_cast<fp_t>(sigma*gauss(rng)),
+                box.z_start + (box.z_end - box.z_start)*static_cast<fp_t>(unit(rng)) });
+        }
+        break;
+
+    case SYNTH_GAUSSIAN: {
+        // Blob centers first, then deposits round robin over blobs.
+        auto n_blobs = spec.n_blobs ? spec.n_blobs : 1;
+        auto spread = n_blobs > 1 ? static_cast<double>(spec.blob_spread) : 0.0;
+        std::vector<Loc> blob_centers;
+        for (uint64_t b = 0; b < n_blobs; ++b) {
+            blob_centers.push_back(Loc{
+                spec.center.x + static_cast<fp_t>(spread*gauss(rng)),
+                spec.center.y + static_cast<fp_t>(spread*gauss(rng)),
+                spec.center.z + static_cast<fp_t>(spread*gauss(rng)) });
+        }
+        for (uint64_t i = 0; i < spec.n_deposits; ++i) {
+            auto& c = blob_centers[i % n_blobs];
+            deposits.push_back(Loc{
+                c.x + static_cast<fp_t>(sigma*gauss(rng)),
+                c.y + static_cast<fp_t>(sigma*gauss(rng)),
+                c.z + static_cast<fp_t>(sigma*gauss(rng)) });
+        }
+        break;
+    }
+
+    case SYNTH_UNIFORM:
+        for (uint64_t i = 0; i < spec.n_deposits; ++i) {
+            deposits.push_back(Loc{
+                box.x_start + (box.x_end - box.x_start)*static_cast<fp_t>(unit(rng)),
+                box.y_start + (box.y_end - box.y_start)*static_cast<fp_t>(unit(rng)),
+                box.z_start + (box.z_end - box.z_start)*static_cast<fp_t>(unit(rng)) });
+        }
+        break;
+
+    default:
+        std::cerr << "SynthDeposits: unknown geometry " \
+            << static_cast<int>(spec.geometry) << std::endl;
+        return deposits;
+    }
+
+    for (auto& pos : deposits) pos = clamp_to_box(pos, box);
+
+    return deposits;
+}
+
+// Geometry by name, -1 if unknown.
+int SynthGeometryFromStr(const std::string& name)
+{
+    std::string lname = name;
+    std::transform(lname.begin(), lname.end(), lname.begin(), ::tolower);
+    if (lname == "point") return SYNTH_POINT;
+    else if (lname == "line") return SYNTH_LINE;
+    else if (lname == "gaussian") return SYNTH_GAUSSIAN;
+    else if (lname == "uniform") return SYNTH_UNIFORM;
+    return -1;
+}
+
+// Electron-hole pairs from deposits
+CarrierList SynthCarriers(
+    const std::vector<Loc>& deposits,
+    const fp_t& electron_mass,
+    const fp_t& hole_mass,
+    const uint64_t& seed)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> delta(
+        static_cast<double>(rand_delta_min),
+        static_cast<double>(rand_delta_max));
+
+    auto carr_vel = Vel{ FP_T(0.0), FP_T(0.0), FP_T(0.0) };
+
+    CarrierList carriers;
+    carriers.reserve(deposits.size()*2);
+    uint64_t carr_index = 0;
+    for (auto& pos : deposits) {
+        carriers.push_back(std::make_shared<Carrier>(
+            q_e, pos, carr_vel, electron_mass, carr_index++));
+
+        Loc hole_pos = pos;
+        hole_pos += Loc{
+            pos.x*static_cast<fp_t>(delta(rng)),
+            pos.y*static_cast<fp_t>(delta(rng)),
+            pos.z*static_cast<fp_t>(delta(rng)) };
+        carriers.push_back(std::make_shared<Carrier>(
+            q_h, hole_pos, carr_vel, hole_mass, carr_index++));
+    }
+
+    return carriers;
+}
+
+// Deposits as input csv text
+std::string SynthDepositCSV(const std::vector<Loc>& deposits)
+{
+    std::stringstream ss;
+    ss << "flagParticle,flagProcess,x,y,z," \
+        << "totalEnergyDeposit,stepLength,kineticEnergyDifference,\n";
+    ss << std::setprecision(9);
+    for (auto& pos : deposits) {
+        ss << "1,0," << pos.x << "," << pos.y << "," << pos.z << ",0,0,0,\n";
+    }
+
+    return ss.str();
+}
+
+// Writes deposits as an input tarball
+int WriteSynthTarball(
+    const std::string& fname,
+    const std::vector<Loc>& deposits)
+{
+    return tarFile(fname.c_str(), SYNTH_CSV_NAME, SynthDepositCSV(deposits));
+}
@@ -0,0 +1,85 @@
+/**
+ *
+ * synth_cloud.h
+ *
+ * Synthetic carrier clouds for benchmarks and scaling studies
+ *
+ * Deposits are generated from a fixed seed so the same arguments
+ * always give the same cloud. They can be turned into carrier pairs
+ * directly or written as an input tarball in the same schema as
+ * the Geant4 data (flagParticle,flagProcess,x,y,z,...).
+ *
+ * Geometries:
+ * - Point: every deposit at the center (worst case clustering)
+ * - Line: track along z through the center, Gaussian radial spread
+ * - Gaussian: one or more Gaussian blobs around the center
+ * - Uniform: uniform fill of the sensor box
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __synth_cloud_h__
+#define __synth_cloud_h__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "fputils.h"
+#include "typedefs.h"
+#include "sim_space.h"
+
+// Default seed of synthetic clouds
+static const uint64_t SYNTH_SEED_DEF = 20161006;
+
+// Cloud geometries
+enum SynthGeometry : uint8_t {
+    SYNTH_POINT = 0,
+    SYNTH_LINE,
+    SYNTH_GAUSSIAN,
+    SYNTH_UNIFORM
+};
+
+// What to generate
+struct SynthCloudSpec {
+    uint64_t n_deposits;
+    uint8_t geometry;
+    Loc center;        // (um)
+    fp_t sigma;        // Blob or track radial spread (um)
+    uint64_t n_blobs;  // Gaussian: number of blobs
+    fp_t blob_spread;  // Gaussian: spread of blob centers (um)
+    Box box;           // Deposits are kept inside this box (um)
+    uint64_t seed;
+};
+
+// Deposits of given spec, clamped into spec.box
+std::vector<Loc> SynthDeposits(const SynthCloudSpec& spec);
+
+// Gaussian blob of n deposits around center with spread sigma (um)
+std::vector<Loc> SynthGaussianDeposits(
+    const uint64_t& n,
+    const Loc& center,
+    const fp_t& sigma,
+    const uint64_t& seed);
+
+// Geometry by name (Point, Line, Gaussian, Uniform), -1 if unknown.
+int SynthGeometryFromStr(const std::string& name);
+
+// Electron-hole pairs from deposits (same layout as generate_carriers,
+// holes are offset by a seeded rand_delta)
+CarrierList SynthCarriers(
+    const std::vector<Loc>& deposits,
+    const fp_t& electron_mass,
+    const fp_t& hole_mass,
+    const uint64_t& seed);
+
+// Deposits as input csv text
+std::string SynthDepositCSV(const std::vector<Loc>& deposits);
+
+// Writes deposits as an input tarball (.tar.bz2, .tar.gz or .tar)
+int WriteSynthTarball(
+    const std::string& fname,
+    const std::vector<Loc>& deposits);
+
+#endif /* Include guard */
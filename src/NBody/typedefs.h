@@ -31,9 +31,13 @@ using CarrierDeque     = std::deque<spCarrier>;
 using CarrierMap       = DataType::Map<uint64_t, spCarrier>;
 
 // Defining the 'CarrierList' type for NBody class
-using CarrierList      = CarrierMap;
+// --> Dense storage: carriers are removed by compaction.
+using CarrierList      = CarrierVector;
 
 using CarrierList_iter = CarrierList::iterator;
 using CarrierSet       = std::set<spCarrier>;
 
+// Indices at CarrierList (i.e. carriers to remove)
+using CarrierIndexList = std::vector<uint64_t>;
+
 #endif /* Include guard */
\ No newline at end of file
@@ -488,6 +488,162 @@ int NBodyVisual::check_table(const char* tab_name)
 
 
 
+// Creates single time indexed table schema (if not there yet)
+//
+// steps: one row per written frame. It goes in with the last batch,
+//        so a frame listed here is complete.
+// carriers: every carrier of every frame, keyed by (step, idx).
+//
+int NBodyVisual::init_db_ts(sqlite3* db)
+{
+    char* zErrMsg = nullptr;
+    std::string create_tables = \
+        std::string("CREATE TABLE IF NOT EXISTS steps ( ") + \
+        "STEP       INTEGER PRIMARY KEY NOT NULL," + \
+        "TIME       REAL              NOT NULL," + \
+        "LABEL      TEXT              NOT NULL," + \
+        "N_CARRIERS INTEGER           NOT NULL );" + \
+        "CREATE INDEX IF NOT EXISTS steps_label ON steps (LABEL);" + \
+        "CREATE TABLE IF NOT EXISTS carriers ( " + \
+        "STEP       INTEGER           NOT NULL," + \
+        "TIME       REAL              NOT NULL," + \
+        "IDX        INTEGER           NOT NULL," + \
+        "TYPE       INTEGER           NOT NULL," + \
+        "MASS       REAL              NOT NULL," + \
+        "X          REAL              NOT NULL," + \
+        "Y          REAL              NOT NULL," + \
+        "Z          REAL              NOT NULL," + \
+        "VX         REAL              NOT NULL," + \
+        "VY         REAL              NOT NULL," + \
+        "VZ         REAL              NOT NULL," + \
+        "FX         REAL              NOT NULL," + \
+        "FY         REAL              NOT NULL," + \
+        "FZ         REAL              NOT NULL," + \
+        "PRIMARY KEY (STEP, IDX) ) WITHOUT ROWID;";
+
+    if (sqlite3_exec(db, create_tables.c_str(), NULL, NULL, &zErrMsg) != SQLITE_OK) {
+        std::cerr << "init_db_ts SQL Error: " << zErrMsg << std::endl;
+        sqlite3_free(zErrMsg);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Writes current carriers into the single time indexed table.
+// Rows go in with one prepared statement, NBV_SQL_BATCH rows per
+// transaction.
+int NBodyVisual::write_carriers_sqlite3_ts(const std::string& label)
+{
+    sqlite3*      carriers_db;
+    sqlite3_stmt* p_carr = nullptr;
+    sqlite3_stmt* p_step = nullptr;
+    int           rc;
+
+    rc = sqlite3_open(this->output_filename.c_str(), &carriers_db);
+    if (rc != SQLITE_OK) {
+        std::cerr << "write_ts SQL Error open: " \
+            << sqlite3_errmsg(carriers_db) << std::endl;
+        return -1;
+    }
+
+    if (this->init_db_ts(carriers_db)) {
+        sqlite3_close(carriers_db);
+        return -1;
+    }
+
+    const char* insert_carr = \
+        "INSERT OR REPLACE INTO carriers " \
+        "(STEP, TIME, IDX, TYPE, MASS, X, Y, Z, VX, VY, VZ, FX, FY, FZ) " \
+        "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14)";
+    const char* insert_step = \
+        "INSERT OR REPLACE INTO steps (STEP, TIME, LABEL, N_CARRIERS) " \
+        "VALUES (?1, ?2, ?3, ?4)";
+
+    if (sqlite3_prepare_v2(carriers_db, insert_carr, -1, &p_carr, NULL) != SQLITE_OK || \
+        sqlite3_prepare_v2(carriers_db, insert_step, -1, &p_step, NULL) != SQLITE_OK) {
+        std::cerr << "write_ts SQL Error prepare: " \
+            << sqlite3_errmsg(carriers_db) << std::endl;
+        sqlite3_finalize(p_carr);
+        sqlite3_finalize(p_step);
+        sqlite3_close(carriers_db);
+        return -1;
+    }
+
+    sqlite3_int64 step = (label == "Init") ? \
+        NBV_SQL_INIT_STEP : static_cast<sqlite3_int64>(this->sim_step);
+    double time = static_cast<double>(this->elapsed_time);
+
+    rc = SQLITE_DONE;
+    uint64_t n_rows = 0;
+    sqlite3_exec(carriers_db, "BEGIN TRANSACTION", NULL, NULL, NULL);
+    for (auto& carrier : this->Carriers) {
+        if (!this->keep_carrier(carrier)) {
+            this->WriteCarrBar.Update();
+            continue;
+        }
+
+        auto pos = carrier->GetPos();
+        auto vel = carrier->GetVel();
+        auto force = carrier->GetForce();
+
+        sqlite3_bind_int64(p_carr, 1, step);
+        sqlite3_bind_double(p_carr, 2, time);
+        sqlite3_bind_int64(p_carr, 3, static_cast<sqlite3_int64>(carrier->GetIndex()));
+        sqlite3_bind_int(p_carr, 4, carrier->GetTypeI());
+        sqlite3_bind_double(p_carr, 5, static_cast<double>(carrier->GetMass()));
+        sqlite3_bind_double(p_carr, 6, static_cast<double>(pos.x));
+        sqlite3_bind_double(p_carr, 7, static_cast<double>(pos.y));
+        sqlite3_bind_double(p_carr, 8, static_cast<double>(pos.z));
+        sqlite3_bind_double(p_carr, 9, static_cast<double>(vel.x));
+        sqlite3_bind_double(p_carr, 10, static_cast<double>(vel.y));
+        sqlite3_bind_double(p_carr, 11, static_cast<double>(vel.z));
+        sqlite3_bind_double(p_carr, 12, static_cast<double>(force.x));
+        sqlite3_bind_double(p_carr, 13, static_cast<double>(force.y));
+        sqlite3_bind_double(p_carr, 14, static_cast<double>(force.z));
+
+        rc = sqlite3_step(p_carr);
+        sqlite3_reset(p_carr);
+        if (rc != SQLITE_DONE) break;
+
+        if (!(++n_rows % NBV_SQL_BATCH)) {
+            sqlite3_exec(carriers_db, "COMMIT", NULL, NULL, NULL);
+            sqlite3_exec(carriers_db, "BEGIN TRANSACTION", NULL, NULL, NULL);
+        }
+        this->WriteCarrBar.Update();
+    }
+
+    // Frame record goes in last.
+    if (rc == SQLITE_DONE) {
+        sqlite3_bind_int64(p_step, 1, step);
+        sqlite3_bind_double(p_step, 2, time);
+        sqlite3_bind_text(p_step, 3, label.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(p_step, 4, static_cast<sqlite3_int64>(n_rows));
+        rc = sqlite3_step(p_step);
+    }
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "write_ts SQL Error step: " \
+            << sqlite3_errmsg(carriers_db) << std::endl;
+        sqlite3_exec(carriers_db, "ROLLBACK", NULL, NULL, NULL);
+    }
+    else {
+        sqlite3_exec(carriers_db, "COMMIT", NULL, NULL, NULL);
+    }
+
+    sqlite3_finalize(p_carr);
+    sqlite3_finalize(p_step);
+
+    if (sqlite3_close(carriers_db) != SQLITE_OK) {
+        std::cerr << "write_ts SQL close error" \
+            << sqlite3_errmsg(carriers_db) \
+            << std::endl;
+        return -1;
+    }
+
+    return (rc == SQLITE_DONE) ? 0 : -1;
+}
+
 // Write a line
 int NBodyVisual::write_line(std::string in_text)
 {
@@ -566,6 +722,7 @@ void NBodyVisual::set_end_delim()
             this->end_delim = this->Delimiters[NBV_OMODE_CSV];
             break;
         case NBV_OMODE_SQLITE3:
+        case NBV_OMODE_SQLITE3_TS:
             this->end_delim = "";
             break;
         default:
@@ -596,6 +753,16 @@ void NBodyVisual::SetOutputMode(unsigned int N)
     this->set_end_delim();
 }
 
+// Whether this build can write given output mode
+bool NBodyVisual::IsOutputModeSupported(unsigned int N)
+{
+    if (N > NBV_OMODE_MAX) return false;
+#if defined(__MULTIPROCESSING_SQLITE3__)
+    if (N == NBV_OMODE_LOG || N == NBV_OMODE_CSV) return false;
+#endif
+    return true;
+}
+
 // Get number of entries
 fp_uint_t NBodyVisual::GetEntries()
 {
@@ -630,20 +797,25 @@ int NBodyVisual::WriteCarriers_sub(
     std::advance(end, istart+ipoints);
 
     for (it; it!=end; ++it) {
+        if (!this->keep_carrier(*it)) {
+            this->WriteCarrBar.Update();
+            continue;
+        }
+
         this->write_carrier_sqlite3_omp(
             ts_str,
-            it->second->GetIndex(),
-            it->second->GetMass(),
-            it->second->GetPos().x,
-            it->second->GetPos().y,
-            it->second->GetPos().z,
-            it->second->GetVel().x,
-            it->second->GetVel().y,
-            it->second->GetVel().z,
-            it->second->GetForce().x,
-            it->second->GetForce().y,
-            it->second->GetForce().z,
-            it->second->GetType());
+            (*it)->GetIndex(),
+            (*it)->GetMass(),
+            (*it)->GetPos().x,
+            (*it)->GetPos().y,
+            (*it)->GetPos().z,
+            (*it)->GetVel().x,
+            (*it)->GetVel().y,
+            (*it)->GetVel().z,
+            (*it)->GetForce().x,
+            (*it)->GetForce().y,
+            (*it)->GetForce().z,
+            (*it)->GetType());
 
         this->WriteCarrBar.Update();
     }
@@ -655,6 +827,11 @@ int NBodyVisual::WriteCarriers_sub(
 int NBodyVisual::WriteCarriers()
 {
     this->timestamp_str = this->to_str(this->elapsed_time);
+
+    // Skip the whole frame if decimation says so.
+    if (!this->OutPolicy.FrameDue(this->sim_step, this->elapsed_time))
+        return 0;
+
     if (this->gen_carr_log) {
         return WriteCarriers(this->timestamp_str);
     }
@@ -681,6 +858,10 @@ int NBodyVisual::WriteCarriers(const std::string& table_name)
     // Setting up timestamp string.
     this->timestamp_str = table_name;
 
+    // Single time indexed table: batched, no per carrier connection.
+    if (this->output_mode == NBV_OMODE_SQLITE3_TS)
+        return this->write_carriers_sqlite3_ts(table_name);
+
     // Multi-processing case...
 #if defined(__MULTIPROCESSING_SQLITE3__)
     if (this->output_mode == NBV_OMODE_LOG || \
@@ -702,7 +883,9 @@ int NBodyVisual::WriteCarriers(const std::string& table_name)
     auto npoints = this->Carriers.size();
     auto omp_timestamp_str = this->timestamp_str;
 
-#pragma omp parallel private(ith, nthreads, ipoints, istart)
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_OUTPUT, npoints);
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ith, nthreads, ipoints, istart)
     {
     ith = omp_get_thread_num();
     nthreads = omp_get_num_threads();
@@ -722,18 +905,23 @@ int NBodyVisual::WriteCarriers(const std::string& table_name)
     auto c_begin = std::begin(this->Carriers);
     auto c_end = std::end(this->Carriers);
     for (auto it = c_begin; it != c_end; ++it) {
-        this->carr_index = it->second->GetIndex();
-        this->carr_mass = it->second->GetMass();
-        this->x_coord = it->second->GetPos().x;
-        this->y_coord = it->second->GetPos().y;
-        this->z_coord = it->second->GetPos().z;
-        this->x_vel = it->second->GetVel().x;
-        this->y_vel = it->second->GetVel().y;
-        this->z_vel = it->second->GetVel().z;
-        this->x_for = it->second->GetForce().x;
-        this->y_for = it->second->GetForce().y;
-        this->z_for = it->second->GetForce().z;
-        this->carr_type = it->second->GetType();
+        if (!this->keep_carrier(*it)) {
+            this->WriteCarrBar.Update();
+            continue;
+        }
+
+        this->carr_index = (*it)->GetIndex();
+        this->carr_mass = (*it)->GetMass();
+        this->x_coord = (*it)->GetPos().x;
+        this->y_coord = (*it)->GetPos().y;
+        this->z_coord = (*it)->GetPos().z;
+        this->x_vel = (*it)->GetVel().x;
+        this->y_vel = (*it)->GetVel().y;
+        this->z_vel = (*it)->GetVel().z;
+        this->x_for = (*it)->GetForce().x;
+        this->y_for = (*it)->GetForce().y;
+        this->z_for = (*it)->GetForce().z;
+        this->carr_type = (*it)->GetType();
 
         switch (this->output_mode) {
         case NBV_OMODE_LOG:
@@ -791,11 +979,13 @@ NBodyVisual::NBodyVisual() : \
     ExtensionMap[NBV_OMODE_LOG] = "log";
     ExtensionMap[NBV_OMODE_CSV] = "csv";
     ExtensionMap[NBV_OMODE_SQLITE3] = "db";
+    ExtensionMap[NBV_OMODE_SQLITE3_TS] = "db";
 
     // Setting up delimiters
     Delimiters[NBV_OMODE_LOG] = "\t";
     Delimiters[NBV_OMODE_CSV] = ",";
     Delimiters[NBV_OMODE_SQLITE3] = "N/A";
+    Delimiters[NBV_OMODE_SQLITE3_TS] = "N/A";
 
     this->output_file = std::ofstream();
     this->set_end_delim();
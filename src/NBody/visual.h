@@ -24,6 +24,8 @@
 #include <map>
 #include <boost/filesystem.hpp>
 
+#include <sqlite3.h>
+
 #include "typedefs.h"
 #include "fputils.h"
 #include "pbar.h"
@@ -31,6 +33,7 @@
 #include "sim_space.h"
 #include "sim_file_io.h"
 #include "sim_progress.h"
+#include "output_policy.h"
 
 // Some SQLITE check stuffs
 #define SQLITE_CHECK_EXISTS 1
@@ -40,7 +43,14 @@
 static const unsigned int NBV_OMODE_LOG = 0;
 static const unsigned int NBV_OMODE_CSV = 1;
 static const unsigned int NBV_OMODE_SQLITE3 = 2;
-static const unsigned int NBV_OMODE_MAX = 2;
+static const unsigned int NBV_OMODE_SQLITE3_TS = 3;
+static const unsigned int NBV_OMODE_MAX = 3;
+
+// Rows per transaction in single table sqlite3 mode
+static const uint64_t NBV_SQL_BATCH = 8192;
+
+// Step number of the initial carrier snapshot (single table mode)
+static const int64_t NBV_SQL_INIT_STEP = -1;
 
 // Some typedef(s)
 using IntMap = std::map<unsigned int, std::string>;
@@ -78,7 +88,8 @@ private:
     //
     // 0: NBody log format (default)
     // 1: csv format
-    // 2: sqlite3 db file (not implemented yet)
+    // 2: sqlite3 db file (one table per timestamp)
+    // 3: sqlite3 db file (single time indexed table)
     //
     unsigned int output_mode;
     // Write carriers as csv
@@ -105,6 +116,9 @@ private:
     int make_table();
     int make_table(std::string table_name);
     int check_table(const char* tab_name);
+    // Single time indexed table: carriers(step, time, idx, ...)
+    int init_db_ts(sqlite3* db);
+    int write_carriers_sqlite3_ts(const std::string& label);
     // and so on...
 
     // Write carrier
@@ -135,10 +149,29 @@ private:
     // Progress Bar
     ProgressBar WriteCarrBar;
 
+protected:
+    // Output decimation and ROI filters (frame timing is checkpointed)
+    CarrierOutputPolicy OutPolicy;
+
+    // Whether a carrier passes the output filters
+    bool keep_carrier(const spCarrier& carrier) const
+    {
+        return !this->OutPolicy.HasCarrierFilter() || \
+            this->OutPolicy.Keep(*carrier, *this->silicon_dimension);
+    }
+
 public:
     // Setup output mode
     void SetOutputMode(unsigned int N);
 
+    // Whether this build can write given output mode
+    // (text modes are off with multiprocessing sqlite3)
+    static bool IsOutputModeSupported(unsigned int N);
+
+    // Setup output decimation and ROI filters
+    void SetOutputPolicy(const CarrierOutputPolicy& policy)
+    { this->OutPolicy = policy; }
+
     // Get entries
     fp_uint_t GetEntries();
 
@@ -0,0 +1,504 @@
+/**
+ *
+ * pdbench.cc
+ *
+ * Micro-benchmarks for the hot paths of pdelay.
+ *
+ * Every benchmark runs on a synthetic Gaussian carrier cloud made
+ * from a fixed seed, so numbers are comparable between builds:
+ *
+ * - CoulombDirect: direct sum of Coulomb force (pairs/s)
+ * - TreeBuild, TreeWalk: Barnes-Hut tree build and grouped walk
+ * - TreeWalkF: grouped walk with single precision pair kernel
+ * - MFPAdj, Diffusion: Brownian and diffusion position updates
+ * - Parse: tarball read and generate_carriers
+ * - Output_<mode>: WriteCarriers for each carrier log format
+ *
+ * Results go to a csv file, one row per benchmark and size.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "cxxopts.hpp" // https://github.com/jarro2783/cxxopts
+#include "CTCForce.h"
+#include "sim_file_io.h"
+#include "visual.h"
+#include "BHTree.h"
+#include "synth_cloud.h"
+#include "sim_dimension.h"
+
+namespace fs = boost::filesystem;
+
+// Defaults
+static const char* BENCH_SIZES_DEF = "1000,10000,100000";
+static const fp_t BENCH_SIGMA_DEF = 5.0;        // Cloud spread (um)
+static const fp_t BENCH_TAU_DEF = 1e-12;        // Drift time (s)
+static const fp_t BENCH_ALPHA_DEF = 0.5;        // Opening angle
+static const uint64_t BENCH_GROUP_DEF = 32;     // Carriers per tree walk
+static const uint64_t BENCH_TARGETS_DEF = 1024; // Direct sum targets
+static const uint64_t BENCH_OUTPUT_MAX = 10000; // Largest cloud written out
+static const double BENCH_MAX_TIME_DEF = 10.0;  // Time to stop repeating (s)
+
+// Scratch input file for the parse and output benchmarks
+static const char* BENCH_TARBALL = "pdbench_synth.tar.bz2";
+
+/**
+ *
+ * Benchmark space: every mixin the kernels need, without a run loop.
+ *
+**/
+class BenchSpace : \
+    public virtual Physics::CTCForce, \
+    public virtual NBodyFileIO, \
+    public virtual NBodyVisual
+{
+public:
+    // Resets carriers to given cloud
+    void SetCloud(const CarrierList& cloud)
+    {
+        this->Carriers.clear();
+        this->Carriers.reserve(cloud.size());
+        for (auto& carrier : cloud)
+            this->Carriers.push_back(std::make_shared<Carrier>(*carrier));
+    }
+
+    BenchSpace(const char* container) : BenchSpace()
+    {
+        this->container_file = container;
+        this->set_logfile_name();
+    }
+
+    BenchSpace()
+    {
+        this->silicon_dimension = std::make_unique<Box>(DIM_BOX);
+        this->ExtBias = std::make_unique<Bias>(BIAS_DEF);
+        this->doping = DOPING_CONC;
+        this->len_scale_f = static_cast<fp_t>(1e6);
+        this->delta_t = BENCH_TAU_DEF;
+        this->forced_delta_t = true;
+    }
+    virtual ~BenchSpace() {;}
+};
+
+// A result row
+struct BenchResult {
+    std::string name;
+    uint64_t n;
+    uint64_t reps;
+    double best;
+    double mean;
+    uint64_t items;
+};
+
+/**
+ *
+ * The benchmark harness
+ *
+**/
+class PDBench
+{
+private:
+    std::vector<uint64_t> sizes;
+    uint64_t seed;
+    uint64_t reps;
+    double max_time;
+    unsigned int threads;
+    fp_t sigma;
+    fp_t tau;
+    fp_t alpha;
+    uint64_t group_size;
+    uint64_t leaf_size;
+    uint64_t targets;
+    uint64_t output_max;
+    std::string output_file;
+    std::string only;
+
+    std::vector<BenchResult> results;
+
+    // Times body up to reps times. setup runs before each rep, untimed.
+    // body returns number of items processed.
+    void run(
+        const std::string& name, const uint64_t& n,
+        std::function<void()> setup,
+        std::function<uint64_t()> body);
+
+    // Selected by --only?
+    bool selected(const std::string& name) const
+    {
+        return this->only.empty() || \
+            name.compare(0, this->only.size(), this->only) == 0;
+    }
+
+    // Fixed seed cloud of n carriers (n/2 pairs)
+    std::vector<Loc> deposits(const uint64_t& n) const;
+    CarrierList cloud(const uint64_t& n) const;
+
+    void bench_coulomb(const uint64_t& n);
+    void bench_tree(const uint64_t& n);
+    void bench_mfp(const uint64_t& n);
+    void bench_parse(const uint64_t& n);
+    void bench_output(const uint64_t& n);
+
+public:
+    int ParseOptions(int argc, char* argv[]);
+    int Run();
+    int WriteResults() const;
+
+    PDBench() : \
+        seed(SYNTH_SEED_DEF),
+        reps(3),
+        max_time(BENCH_MAX_TIME_DEF),
+        threads(1),
+        sigma(BENCH_SIGMA_DEF),
+        tau(BENCH_TAU_DEF),
+        alpha(BENCH_ALPHA_DEF),
+        group_size(BENCH_GROUP_DEF),
+        leaf_size(BHTREE_LEAF_SIZE_DEF),
+        targets(BENCH_TARGETS_DEF),
+        output_max(BENCH_OUTPUT_MAX),
+        output_file("pdbench.csv"),
+        only({})
+    {;}
+    virtual ~PDBench() {;}
+};
+
+// Times body up to reps times.
+void PDBench::run(
+    const std::string& name, const uint64_t& n,
+    std::function<void()> setup,
+    std::function<uint64_t()> body)
+{
+    if (!this->selected(name)) return;
+
+    // Stops repeating once max_time is spent.
+    BenchResult result{ name, n, 0, 0.0, 0.0, 0 };
+    double total = 0.0;
+    while (result.reps < this->reps && (!result.reps || total < this->max_time)) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        result.items = body();
+        std::chrono::duration<double> dur = \
+            std::chrono::steady_clock::now() - start;
+        if (!result.reps || dur.count() < result.best) result.best = dur.count();
+        total += dur.count();
+        ++result.reps;
+    }
+    result.mean = total / result.reps;
+
+    std::cout << std::left << std::setw(24) << name \
+        << std::right << std::setw(10) << n \
+        << std::setw(14) << std::scientific << std::setprecision(4) \
+        << result.best << " s" \
+        << std::setw(14) << result.items / result.best << " /s" \
+        << std::defaultfloat << std::endl;
+
+    this->results.push_back(result);
+}
+
+// Fixed seed deposits for n carriers
+std::vector<Loc> PDBench::deposits(const uint64_t& n) const
+{
+    return SynthGaussianDeposits(
+        (n + 1) / 2, Loc{ 0.0, 0.0, 250.0 }, this->sigma, this->seed);
+}
+
+// Fixed seed cloud of n carriers
+CarrierList PDBench::cloud(const uint64_t& n) const
+{
+    BenchSpace space;
+    auto electron_mass = space.DetMaterial.GetSemi("Silicon", "MVTHN")*m_elec;
+    auto hole_mass = space.DetMaterial.GetSemi("Silicon", "MVTHP")*m_elec;
+    auto carriers = SynthCarriers(
+        this->deposits(n), electron_mass, hole_mass, this->seed);
+    if (carriers.size() > n) carriers.resize(n);
+    return carriers;
+}
+
+// Direct sum: a strided subset of targets against every carrier.
+void PDBench::bench_coulomb(const uint64_t& n)
+{
+    BenchSpace space;
+    space.SetCloud(this->cloud(n));
+    uint64_t n_targets = std::min<uint64_t>(this->targets, n);
+    uint64_t stride = n / n_targets;
+
+    this->run("CoulombDirect", n,
+        [&]() { for (auto& carrier : space.Carriers) carrier->ResetVelnForce(); },
+        [&]() {
+            auto& carriers = space.Carriers;
+#pragma omp parallel for schedule(static)
+            for (int64_t t = 0; t < static_cast<int64_t>(n_targets); ++t) {
+                auto& carrier = carriers[t*stride];
+                for (auto& other : carriers) {
+                    if (other == carrier) continue;
+                    carrier->AddForce(space.CoulombForce(carrier, other));
+                }
+            }
+            return n_targets*(n - 1);
+        });
+}
+
+// Tree build (root fitted to the cloud) and grouped walk.
+void PDBench::bench_tree(const uint64_t& n)
+{
+    BenchSpace space;
+    space.SetCloud(this->cloud(n));
+
+    BHTreeArena arena;
+    arena.leaf_size = this->leaf_size;
+    BHTree* tree = nullptr;
+    auto build = [&]() {
+        arena.Reset();
+        tree = arena.NewNode(CloudOctant(space.Carriers));
+        for (auto& carrier : space.Carriers) tree->insert(carrier);
+        tree->UpdateMoments();
+    };
+
+    this->run("TreeBuild", n, []() {;},
+        [&]() { build(); return n; });
+
+    std::vector<const BHTree*> groups;
+    auto walk = [&](const char* name, const unsigned int prec) {
+        this->run(name, n,
+            [&]() {
+                build();
+                groups.clear();
+                tree->CollectGroups(this->group_size, groups);
+            },
+            [&]() {
+                uint64_t pairs = 0;
+#pragma omp parallel reduction(+:pairs)
+                {
+                    InteractionList list;
+                    CarrierVector group;
+#pragma omp for schedule(dynamic, 16)
+                    for (int64_t i = 0; i < static_cast<int64_t>(groups.size()); ++i) {
+                        group.clear();
+                        groups[i]->CollectCarriers(group);
+                        auto g_min = group.front()->GetPos();
+                        auto g_max = group.front()->GetPos();
+                        for (auto& carrier : group) {
+                            auto pos = carrier->GetPos();
+                            g_min = Loc{
+                                fp_min<fp_t>(g_min.x, pos.x),
+                                fp_min<fp_t>(g_min.y, pos.y),
+                                fp_min<fp_t>(g_min.z, pos.z) };
+                            g_max = Loc{
+                                fp_max<fp_t>(g_max.x, pos.x),
+                                fp_max<fp_t>(g_max.y, pos.y),
+                                fp_max<fp_t>(g_max.z, pos.z) };
+                        }
+                        list.clear();
+                        tree->BuildInteractionList(g_min, g_max, this->alpha, list);
+                        if (prec == PAIR_PREC_FLOAT)
+                            list.to_float((g_min + g_max) / FP_T(2.0));
+                        space.CoulombForceGroup(list, group, prec);
+                        pairs += list.size()*group.size();
+                    }
+                }
+                return pairs;
+            });
+    };
+
+    walk("TreeWalk", PAIR_PREC_DOUBLE);
+    walk("TreeWalkF", PAIR_PREC_FLOAT);
+}
+
+// Brownian (MFPAdj) and diffusion position updates
+void PDBench::bench_mfp(const uint64_t& n)
+{
+    BenchSpace space;
+    auto carriers = this->cloud(n);
+    auto tau = this->tau;
+
+    this->run("MFPAdj", n,
+        [&]() { space.SetCloud(carriers); },
+        [&]() {
+#pragma omp parallel for schedule(static)
+            for (int64_t i = 0; i < static_cast<int64_t>(n); ++i)
+                space.MFPAdj(space.Carriers[i], tau);
+            return n;
+        });
+
+    this->run("Diffusion", n,
+        [&]() { space.SetCloud(carriers); },
+        [&]() {
+#pragma omp parallel for schedule(static)
+            for (int64_t i = 0; i < static_cast<int64_t>(n); ++i)
+                space.Diffusion(space.Carriers[i], tau);
+            return n;
+        });
+}
+
+// Tarball read and carrier generation
+void PDBench::bench_parse(const uint64_t& n)
+{
+    if (!this->selected("Parse")) return;
+    if (WriteSynthTarball(BENCH_TARBALL, this->deposits(n))) return;
+
+    std::unique_ptr<BenchSpace> space;
+    this->run("Parse", n,
+        [&]() { space = std::make_unique<BenchSpace>(BENCH_TARBALL); },
+        [&]() {
+            space->InitialData = std::make_unique<ReadData>(BENCH_TARBALL);
+            space->generate_carriers();
+            return static_cast<uint64_t>(space->Carriers.size());
+        });
+
+    fs::remove(BENCH_TARBALL);
+}
+
+// WriteCarriers for each output mode
+void PDBench::bench_output(const uint64_t& n)
+{
+    if (n > this->output_max) return;
+
+    const char* mode_str[NBV_OMODE_MAX + 1] = {
+        "Log", "CSV", "Sqlite3", "Sqlite3TS"
+    };
+    auto carriers = this->cloud(n);
+
+    for (unsigned int mode = 0; mode <= NBV_OMODE_MAX; ++mode) {
+        std::string name = std::string("Output_") + mode_str[mode];
+        if (!this->selected(name)) continue;
+        if (!NBodyVisual::IsOutputModeSupported(mode)) {
+            std::cout << name << ": not available in this build." << std::endl;
+            continue;
+        }
+
+        BenchSpace space(BENCH_TARBALL);
+        space.SetCloud(carriers);
+        space.SetOutputMode(mode);
+        space.SetCarrLogGen(true);
+
+        uint64_t frame = 0;
+        this->run(name, n, []() {;},
+            [&]() {
+                space.WriteCarriers(std::string("bench_") + std::to_string(frame++));
+                return n;
+            });
+
+        fs::remove(space.GetFileName());
+        fs::remove(space.logfile_name);
+    }
+}
+
+// Runs everything
+int PDBench::Run()
+{
+#ifdef _OPENMP
+    omp_set_num_threads(this->threads);
+#endif
+
+    for (auto& n : this->sizes) {
+        this->bench_coulomb(n);
+        this->bench_tree(n);
+        this->bench_mfp(n);
+        this->bench_parse(n);
+        this->bench_output(n);
+    }
+
+    return this->WriteResults();
+}
+
+// Writes results as csv
+int PDBench::WriteResults() const
+{
+    std::ofstream ofs(this->output_file, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+        std::cerr << "Cannot write benchmark results to: " \
+            << this->output_file << std::endl;
+        return -1;
+    }
+
+    ofs << "\"Benchmark\",\"N\",\"Threads\",\"Seed\",\"Reps\"," \
+        << "\"Best(s)\",\"Mean(s)\",\"Items\",\"Items/s\"\n";
+    ofs << std::scientific << std::setprecision(6);
+    for (auto& result : this->results) {
+        ofs << result.name << "," << result.n << "," \
+            << this->threads << "," << this->seed << "," \
+            << result.reps << "," << result.best << "," << result.mean << "," \
+            << result.items << "," << result.items / result.best << "\n";
+    }
+    ofs.close();
+
+    std::cout << "Benchmark results: " << this->output_file << std::endl;
+    return 0;
+}
+
+// Parse options
+int PDBench::ParseOptions(int argc, char* argv[])
+{
+    std::string sizes_str;
+
+    auto options = cxxopts::Options("PDBench", "Micro-benchmarks for pdelay");
+    options.add_options()
+        ("h,help", "Shows help message")
+        ("p,procs", "Number of threads", cxxopts::value<unsigned int>(threads)->default_value("1"))
+        ("n,sizes", "Carrier counts, comma separated", cxxopts::value<std::string>(sizes_str)->default_value(BENCH_SIZES_DEF))
+        ("seed", "Seed of synthetic clouds", cxxopts::value<uint64_t>(seed)->default_value(std::to_string(SYNTH_SEED_DEF)))
+        ("reps", "Max. repetitions per benchmark", cxxopts::value<uint64_t>(reps)->default_value("3"))
+        ("max_time", "Stop repeating a benchmark after this many seconds", cxxopts::value<double>(max_time)->default_value("10"))
+        ("sigma", "Cloud spread (um)", cxxopts::value<fp_t>(sigma)->default_value("5"))
+        ("tau", "Drift time for MFPAdj/Diffusion (s)", cxxopts::value<fp_t>(tau)->default_value("1e-12"))
+        ("alpha", "Tree opening angle", cxxopts::value<fp_t>(alpha)->default_value("0.5"))
+        ("group_size", "Max. carriers sharing a tree walk", cxxopts::value<uint64_t>(group_size)->default_value("32"))
+        ("leaf_size", "Max. carriers per tree leaf", cxxopts::value<uint64_t>(leaf_size)->default_value(std::to_string(BHTREE_LEAF_SIZE_DEF)))
+        ("targets", "Direct sum targets per size", cxxopts::value<uint64_t>(targets)->default_value("1024"))
+        ("output_max", "Largest cloud for output benchmarks", cxxopts::value<uint64_t>(output_max)->default_value("10000"))
+        ("only", "Run benchmarks starting with this name only", cxxopts::value<std::string>(only))
+        ("o,output", "Result csv file", cxxopts::value<std::string>(output_file)->default_value("pdbench.csv"))
+        ;
+
+    options.parse(argc, argv);
+
+    if (options.count("help")) {
+        std::cout << options.help({ "" }) << std::endl;
+        exit(0);
+    }
+
+    std::stringstream ss(sizes_str);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        if (token.empty()) continue;
+        auto n = static_cast<uint64_t>(std::stod(token));
+        if (n < 2) {
+            std::cerr << "Benchmark size must be 2 or more: " << token << std::endl;
+            exit(-1);
+        }
+        this->sizes.push_back(n);
+    }
+    if (!this->reps) this->reps = 1;
+    if (!this->threads) this->threads = 1;
+    if (!this->group_size) this->group_size = 1;
+    if (!this->leaf_size) this->leaf_size = 1;
+    if (!this->targets) this->targets = 1;
+
+    return 0;
+}
+
+/**
+ *
+ * The main function...
+ *
+**/
+int main(int argc, char* argv[])
+{
+    PDBench Bench;
+    Bench.ParseOptions(argc, argv);
+
+    return Bench.Run();
+}
@@ -105,6 +105,8 @@ void PDelay::usage(const char* exec_name)
         "            In fact, you don't need this option but\n";
     options_description += \
         "            just put in filename... \n";
+    options_description += \
+        "            A .ckpt file (i.e. from pdgen) is loaded as a checkpoint.\n";
     options_description += \
         "-d <file> : Input (SQLite3) material database.\n";
     options_description += \
@@ -129,6 +131,118 @@ void PDelay::usage(const char* exec_name)
         "-o <doping_concentration> : forces doping concentration.\n";
     options_description += \
         "            If not given, assumes 3.59e+11.\n";
+    options_description += \
+        "--tree_walk <mode> : Octree force walk mode (Carrier or Group).\n";
+    options_description += \
+        "            Group mode lets carriers in a leaf bucket share one walk.\n";
+    options_description += \
+        "--group_size <n> : Max. carriers per group in Group mode (default: 32).\n";
+    options_description += \
+        "--force_engine <engine> : Coulomb force engine: Native (default),\n";
+    options_description += \
+        "            Direct, Tree (Octree only), Mesh or Auto. Auto calibrates\n";
+    options_description += \
+        "            the engines at startup and picks the cheapest every step.\n";
+    options_description += \
+        "            Auto walks the tree in Group mode.\n";
+    options_description += \
+        "--force_float <engines> : Engines with single precision pair kernel,\n";
+    options_description += \
+        "            comma separated: Direct, Tree, Mesh, All or None (default).\n";
+    options_description += \
+        "            Tree applies to Group walk. Error is reported at the end.\n";
+    options_description += \
+        "--alpha <a> : Octree opening threshold (default: 0.5).\n";
+    options_description += \
+        "            Carrier walk: larger is more accurate. Group walk: smaller is.\n";
+    options_description += \
+        "--leaf_size <n>, --tree_max_depth <n> : Max. carriers per octree leaf\n";
+    options_description += \
+        "            and depth limit of the octree (default: 8, 48).\n";
+    options_description += \
+        "--force_check <file> : Compare sampled tree forces to the direct sum\n";
+    options_description += \
+        "            and write relative RMS/max error to <file> (Octree only).\n";
+    options_description += \
+        "--force_check_every <n>, --force_check_samples <n> : Check interval\n";
+    options_description += \
+        "            and sampled carriers per check (default: 10, 64).\n";
+    options_description += \
+        "--force_tol <err> : Target relative RMS force error. Adjusts alpha to\n";
+    options_description += \
+        "            the loosest value meeting it (0: off, default).\n";
+    options_description += \
+        "--omp_serial_below <n> : Per step OpenMP regions with fewer carriers\n";
+    options_description += \
+        "            run on one thread (default: 64, 0: never).\n";
+    options_description += \
+        "--omp_min_items <n>, --omp_min_work <us> : Min. carriers and min.\n";
+    options_description += \
+        "            measured work per thread (default: 16, 20). Smaller\n";
+    options_description += \
+        "            clouds use fewer threads.\n";
+    options_description += \
+        "--capture_radius <um> : Electron-hole pairs closer than this recombine.\n";
+    options_description += \
+        "            If not given (or 0), carrier to carrier recombination is off.\n";
+    options_description += \
+        "--fast_forward <ratio> : Carriers with space charge force below <ratio>\n";
+    options_description += \
+        "            of the drift force are collected in closed form (0: off).\n";
+    options_description += \
+        "            Clouds qualify up to about 13000*<ratio> carriers at 4e5 V/m,\n";
+    options_description += \
+        "            so it mostly acts on the tail of a run.\n";
+    options_description += \
+        "--reorder_every <n> : Sort carriers along a Morton curve every n steps\n";
+    options_description += \
+        "            for memory locality (default: 0, off).\n";
+    options_description += \
+        "--reorder_disorder <f> : Also sort if more than this fraction of\n";
+    options_description += \
+        "            neighbours is out of order, i.e. 0.25 (default: 0, off).\n";
+    options_description += \
+        "--event_echo <n> : Max. carrier events echoed to console per step (default: 10).\n";
+    options_description += \
+        "            0 turns off console echo. The logfile always gets all events.\n";
+    options_description += \
+        "--db_schema <schema> : Carrier database layout (PerStep or Single).\n";
+    options_description += \
+        "            Single writes one time indexed table in batches (default: PerStep).\n";
+    options_description += \
+        "--checkpoint_every <n> : Write a checkpoint every n steps (0: off).\n";
+    options_description += \
+        "--checkpoint_minutes <min> : Write a checkpoint every <min> minutes (0: off).\n";
+    options_description += \
+        "--checkpoint_file <file> : Checkpoint filename (default: <input>.ckpt).\n";
+    options_description += \
+        "--restart <file> : Restart simulation from a checkpoint file.\n";
+    options_description += \
+        "--out_every <n> : Write carrier log every n steps (0: every step).\n";
+    options_description += \
+        "--out_dt <s> : Write carrier log every <s> seconds of simulated time.\n";
+    options_description += \
+        "--out_fraction <f> : Write only a fixed subsample (0 < f <= 1) of carriers.\n";
+    options_description += \
+        "--out_roi <box> : Write only carriers in x<xs>:<xe>y<ys>:<ye>z<zs>:<ze> (um).\n";
+    options_description += \
+        "--out_electrode <um> : Write only carriers within <um> of the electrodes.\n";
+    options_description += \
+        "            Output filters above can be combined; all of them must pass.\n";
+    options_description += \
+        "--current <file> : Write induced electrode current I(t) to a csv file.\n";
+    options_description += \
+        "--stats <prefix> : Write cloud moments and collection histograms.\n";
+    options_description += \
+        "            <prefix>_moments.csv (every step) and <prefix>_hist.csv.\n";
+    options_description += \
+        "--stats_t_bin <s>, --stats_r_bin <um> : Histogram bins (default: 1e-12, 1).\n";
+    options_description += \
+        "--profile <prefix> : Write phase timings to <prefix>_steps.csv and\n";
+    options_description += \
+        "            a Chrome trace to <prefix>_trace.json.\n";
+    options_description += \
+        "--profile_hw <True|False> : Add cycles/instructions via perf_event_open.\n";
 
 
     std::cerr << std::endl;
@@ -226,8 +340,44 @@ int PDelay::RunOneToOne()
     if (force_delta_t)
         NBodyRunner->SetDeltaT(delta_t);
 
+    // Setting up force engine.
+    this->NBodyRunner->SetForceEngine(force_engine);
+    this->NBodyRunner->SetForcePrecision(force_float, PAIR_PREC_FLOAT);
+
     // Setting up visualization data (carrier log data) format.
     this->NBodyRunner->SetCarrierDataFormat(vis_mode);
+    this->NBodyRunner->SetOutputPolicy(this->OutPolicy);
+
+    // Setting up OpenMP team sizes.
+    this->NBodyRunner->SetOmpPolicy(omp_serial_below, omp_min_items, omp_min_work);
+
+    // Setting up carrier to carrier recombination.
+    this->NBodyRunner->SetCaptureRadius(capture_radius);
+
+    // Setting up fast forward of isolated carriers.
+    this->NBodyRunner->SetFastForward(fast_forward);
+
+    // Setting up Morton ordering of carrier storage.
+    this->NBodyRunner->SetReorder(reorder_every, reorder_disorder);
+
+    // Setting up console echo of carrier events.
+    this->NBodyRunner->SetEventEchoLimit(event_echo);
+
+    // Setting up checkpoint and restart.
+    this->NBodyRunner->SetCheckpoint(
+        checkpoint_every, checkpoint_minutes, checkpoint_file);
+    this->NBodyRunner->SetRestartFile(restart_file);
+
+    // Setting up induced current output.
+    this->NBodyRunner->SetSignalFile(current_file, !restart_file.empty());
+
+    // Setting up streaming statistics.
+    this->NBodyRunner->SetStats(
+        stats_prefix, stats_t_bin, stats_r_bin, !restart_file.empty());
+
+    // Setting up profiler.
+    this->NBodyRunner->SetProfile(
+        profile_prefix, str_to_lower(profile_hw_str) == "true");
 
     // Now run the simulation
     if (this->sim_algorithm_i == sdkd)
@@ -296,6 +446,51 @@ int PDelay::RunOctree()
 
     // Setting up visualization data (carrier log data) format.
     this->NBodyOctreeRunner->SetCarrierDataFormat(vis_mode);
+    this->NBodyOctreeRunner->SetOutputPolicy(this->OutPolicy);
+
+    // Setting up tree walk.
+    this->NBodyOctreeRunner->SetTreeWalkMode(tree_walk);
+    this->NBodyOctreeRunner->SetGroupSize(group_size);
+    this->NBodyOctreeRunner->SetAlpha(tree_alpha);
+    this->NBodyOctreeRunner->SetLeafSize(leaf_size);
+    this->NBodyOctreeRunner->SetTreeMaxDepth(tree_max_depth);
+    this->NBodyOctreeRunner->SetForceEngine(force_engine);
+    this->NBodyOctreeRunner->SetForcePrecision(force_float, PAIR_PREC_FLOAT);
+
+    // Setting up force accuracy check.
+    this->NBodyOctreeRunner->SetForceAccuracy(
+        force_check_every, force_check_samples, force_tol, force_check_file);
+
+    // Setting up OpenMP team sizes.
+    this->NBodyOctreeRunner->SetOmpPolicy(omp_serial_below, omp_min_items, omp_min_work);
+
+    // Setting up carrier to carrier recombination.
+    this->NBodyOctreeRunner->SetCaptureRadius(capture_radius);
+
+    // Setting up fast forward of isolated carriers.
+    this->NBodyOctreeRunner->SetFastForward(fast_forward);
+
+    // Setting up Morton ordering of carrier storage.
+    this->NBodyOctreeRunner->SetReorder(reorder_every, reorder_disorder);
+
+    // Setting up console echo of carrier events.
+    this->NBodyOctreeRunner->SetEventEchoLimit(event_echo);
+
+    // Setting up checkpoint and restart.
+    this->NBodyOctreeRunner->SetCheckpoint(
+        checkpoint_every, checkpoint_minutes, checkpoint_file);
+    this->NBodyOctreeRunner->SetRestartFile(restart_file);
+
+    // Setting up induced current output.
+    this->NBodyOctreeRunner->SetSignalFile(current_file, !restart_file.empty());
+
+    // Setting up streaming statistics.
+    this->NBodyOctreeRunner->SetStats(
+        stats_prefix, stats_t_bin, stats_r_bin, !restart_file.empty());
+
+    // Setting up profiler.
+    this->NBodyOctreeRunner->SetProfile(
+        profile_prefix, str_to_lower(profile_hw_str) == "true");
 
     // Now run the simulation
     if (this->sim_algorithm_i == sdkd)
@@ -369,6 +564,41 @@ int PDelay::ParseOptions(int argc, char* argv[])
         ("l,carrier_log", "Generate carrier log (default: False)", cxxopts::value<std::string>(c_log_str)->default_value("False"))
         ("b,bias", "Setting up bias <bias_between_electrode> or <anode>:<cathode>", cxxopts::value<std::string>(bias_str)->default_value("-200:-1"))
         ("dim", "Setting up dimension x<x_start>:<x_end>y<y_start>:<y_end>z<z_start>:<z_end>", cxxopts::value<std::string>(dimension_str)->default_value("x-10000:10000y-10000:10000z0:500"))
+        ("tree_walk", "Octree force walk mode (Carrier, Group)", cxxopts::value<std::string>(tree_walk_str)->default_value("Carrier"))
+        ("group_size", "Max. carriers sharing a tree walk in Group mode", cxxopts::value<unsigned int>(group_size)->default_value("32"))
+        ("force_engine", "Force engine (Native, Direct, Tree, Mesh, Auto)", cxxopts::value<std::string>(force_engine_str)->default_value("Native"))
+        ("force_float", "Engines with single precision pair kernel (Direct, Tree, Mesh, All, None)", cxxopts::value<std::string>(force_float_str)->default_value("None"))
+        ("alpha", "Octree opening threshold", cxxopts::value<fp_t>(tree_alpha)->default_value("0.5"))
+        ("leaf_size", "Max. carriers per octree leaf", cxxopts::value<uint64_t>(leaf_size)->default_value(std::to_string(BHTREE_LEAF_SIZE_DEF)))
+        ("tree_max_depth", "Octree depth limit", cxxopts::value<uint64_t>(tree_max_depth)->default_value(std::to_string(BHTREE_MAX_DEPTH_DEF)))
+        ("force_check", "Force accuracy csv file", cxxopts::value<std::string>(force_check_file))
+        ("force_check_every", "Force accuracy check every n steps", cxxopts::value<uint64_t>(force_check_every)->default_value(std::to_string(ACC_EVERY_DEF)))
+        ("force_check_samples", "Carriers sampled per force accuracy check", cxxopts::value<uint64_t>(force_check_samples)->default_value(std::to_string(ACC_SAMPLES_DEF)))
+        ("force_tol", "Target relative rms force error (0: off)", cxxopts::value<fp_t>(force_tol)->default_value("0"))
+        ("omp_serial_below", "OpenMP regions with fewer carriers run serial (0: never)", cxxopts::value<uint64_t>(omp_serial_below)->default_value(std::to_string(OMP_SERIAL_BELOW_DEF)))
+        ("omp_min_items", "Min. carriers per OpenMP thread", cxxopts::value<uint64_t>(omp_min_items)->default_value(std::to_string(OMP_MIN_ITEMS_DEF)))
+        ("omp_min_work", "Min. measured work per OpenMP thread in us (0: off)", cxxopts::value<double>(omp_min_work)->default_value("20"))
+        ("capture_radius", "Electron-hole recombination capture radius in um (0: off)", cxxopts::value<fp_t>(capture_radius)->default_value("0"))
+        ("fast_forward", "Max. space charge to drift force ratio for closed form collection (0: off)", cxxopts::value<fp_t>(fast_forward)->default_value("0"))
+        ("reorder_every", "Sort carriers along Morton curve every n steps (0: off)", cxxopts::value<uint64_t>(reorder_every)->default_value("0"))
+        ("reorder_disorder", "Sort carriers if this fraction of neighbours is out of order (0: off)", cxxopts::value<fp_t>(reorder_disorder)->default_value("0"))
+        ("event_echo", "Max. carrier events echoed to console per step (0: off)", cxxopts::value<unsigned int>(event_echo)->default_value("10"))
+        ("db_schema", "Carrier database layout (PerStep, Single)", cxxopts::value<std::string>(db_schema_str)->default_value("PerStep"))
+        ("checkpoint_every", "Write checkpoint every n steps (0: off)", cxxopts::value<uint64_t>(checkpoint_every)->default_value("0"))
+        ("checkpoint_minutes", "Write checkpoint every n minutes (0: off)", cxxopts::value<fp_t>(checkpoint_minutes)->default_value("0"))
+        ("checkpoint_file", "Checkpoint filename", cxxopts::value<std::string>(checkpoint_file))
+        ("restart", "Restart from checkpoint file", cxxopts::value<std::string>(restart_file))
+        ("out_every", "Write carrier log every n steps", cxxopts::value<uint64_t>(out_every)->default_value("0"))
+        ("out_dt", "Write carrier log every dt seconds of simulated time", cxxopts::value<fp_t>(out_dt)->default_value("0"))
+        ("out_fraction", "Fraction of carriers written to carrier log", cxxopts::value<fp_t>(out_fraction)->default_value("1"))
+        ("out_roi", "Carrier log region of interest x<xs>:<xe>y<ys>:<ye>z<zs>:<ze>", cxxopts::value<std::string>(out_roi_str))
+        ("out_electrode", "Write carriers within this distance (um) of electrodes", cxxopts::value<fp_t>(out_electrode)->default_value("0"))
+        ("current", "Induced electrode current csv file", cxxopts::value<std::string>(current_file))
+        ("stats", "Streaming statistics output prefix", cxxopts::value<std::string>(stats_prefix))
+        ("stats_t_bin", "Collection time histogram bin (s)", cxxopts::value<fp_t>(stats_t_bin)->default_value("1e-12"))
+        ("stats_r_bin", "Collection radius histogram bin (um)", cxxopts::value<fp_t>(stats_r_bin)->default_value("1"))
+        ("profile", "Profiler output prefix", cxxopts::value<std::string>(profile_prefix))
+        ("profile_hw", "Profiler hardware counters (default: False)", cxxopts::value<std::string>(profile_hw_str)->default_value("False"))
         ;
 
     options.parse_positional({ "input", "procs", "positional" });
@@ -383,6 +613,20 @@ int PDelay::ParseOptions(int argc, char* argv[])
         continued = true;
     }
 
+    // A checkpoint as input (i.e. a binary cache from pdgen)
+    // works the same as --restart.
+    if (restart_file.empty() && \
+        boost::algorithm::iends_with(input_file, ".ckpt")) {
+        restart_file = input_file;
+    }
+
+    // if restart file is given, continue from the checkpoint.
+    if (!restart_file.empty()) {
+        restart_file = GetFullPath(restart_file);
+        input_file = restart_file;
+        continued = true;
+    }
+
     // Convert input file path to proper native path
     input_file = GetFullPath(input_file);
 
@@ -412,6 +656,31 @@ int PDelay::ParseOptions(int argc, char* argv[])
     // Set up simulation calculation mode
     this->SetAlgorithm(algorithm);
 
+    // Set up tree walk mode
+    this->SetTreeWalk(tree_walk_str);
+
+    // Setting up force engine
+    this->SetForceEngine(force_engine_str);
+    this->SetForceFloat(force_float_str);
+
+    // Auto swaps the tree for Direct or Mesh: the tree has to give the
+    // same forces, which only the Group walk does (far field included).
+    if (this->force_engine == FENG_AUTO && this->sim_mode_i == octree && \
+        this->tree_walk == BHT_WALK_CARRIER) {
+        if (options.count("tree_walk")) {
+            std::cout << "Error!! Auto force engine needs Group tree walk!!" \
+                << std::endl;
+            exit(-1);
+        }
+        this->SetTreeWalk("Group");
+    }
+
+    // Set up carrier database layout
+    this->SetDBSchema(db_schema_str);
+
+    // Set up checkpoint file
+    this->SetCheckpointFile();
+
     // Set up c_log
     if (str_to_lower(c_log_str) == "false")
         this->c_log = false;
@@ -434,24 +703,11 @@ int PDelay::ParseOptions(int argc, char* argv[])
     }
 
     // Set up dimension
-    if (!dimension_str.empty()) {
-        auto x_ind = dimension_str.find_first_of("x");
-        auto y_ind = dimension_str.find_first_of("y");
-        auto z_ind = dimension_str.find_first_of("z");
-        auto x_portion = dimension_str.substr(x_ind+1, y_ind);
-        auto y_portion = dimension_str.substr(y_ind+1, z_ind);
-        auto z_portion = dimension_str.substr(z_ind+1);
-        auto x_colon = x_portion.find_first_of(":");
-        auto y_colon = y_portion.find_first_of(":");
-        auto z_colon = z_portion.find_first_of(":");
-        auto x_start = str_to_num<fp_t>(x_portion.substr(0, x_colon));
-        auto x_end = str_to_num<fp_t>(x_portion.substr(x_colon+1));
-        auto y_start = str_to_num<fp_t>(y_portion.substr(0, y_colon));
-        auto y_end = str_to_num<fp_t>(y_portion.substr(y_colon+1));
-        auto z_start = str_to_num<fp_t>(z_portion.substr(0, z_colon));
-        auto z_end = str_to_num<fp_t>(z_portion.substr(z_colon+1));
-        this->SetDimension(x_start, x_end, y_start, y_end, z_start, z_end);
-    }
+    if (!dimension_str.empty())
+        this->SetDimension(ParseBox(dimension_str));
+
+    // Set up carrier log decimation and ROI
+    this->SetOutputPolicy();
 
     return 0;
 }
@@ -616,6 +872,116 @@ int PDelay::SetSimMode(const char* new_sim_mode)
 {
     return SetSimMode(std::string(new_sim_mode));
 }
+int PDelay::SetTreeWalk(const std::string& new_tree_walk)
+{
+    if (str_to_lower(new_tree_walk) == "group") {
+        this->tree_walk = BHT_WALK_GROUP;
+        std::cout << "Setting up tree walk: Group (up to " \
+            << group_size << " carriers)" << std::endl;
+    }
+    else if (str_to_lower(new_tree_walk) == "carrier") {
+        this->tree_walk = BHT_WALK_CARRIER;
+    }
+    else {
+        std::cout << "Error!! Wrong tree walk mode!!" << std::endl;
+        std::cout << "Use one of: Carrier, Group" << std::endl;
+        exit(-1);
+    }
+
+    return this->tree_walk;
+}
+int PDelay::SetForceEngine(const std::string& new_force_engine)
+{
+    auto engine = ForceEngineFromStr(new_force_engine);
+    if (engine < 0) {
+        std::cout << "Error!! Wrong force engine!!" << std::endl;
+        std::cout << "Use one of: Native, Direct, Tree, Mesh, Auto" << std::endl;
+        exit(-1);
+    }
+    if (engine == FENG_TREE && this->sim_mode_i != octree) {
+        std::cout << "Error!! Tree engine needs the Octree model!!" << std::endl;
+        exit(-1);
+    }
+    this->force_engine = static_cast<unsigned int>(engine);
+    if (this->force_engine != FENG_NATIVE) {
+        std::cout << "Setting up force engine: " \
+            << NBodyForceEngine::ForceEngineName(this->force_engine) << std::endl;
+    }
+
+    return this->force_engine;
+}
+int PDelay::SetForceFloat(const std::string& new_force_float)
+{
+    auto engines = ForceEngineBitsFromStr(new_force_float);
+    if (engines < 0) {
+        std::cout << "Error!! Wrong single precision force engine!!" << std::endl;
+        std::cout << "Use any of: Direct, Tree, Mesh, All, None" << std::endl;
+        exit(-1);
+    }
+    this->force_float = static_cast<unsigned int>(engines);
+    for (unsigned int engine = 0; engine < FENG_N_ENGINES; ++engine) {
+        if (!((this->force_float >> engine) & 1U)) continue;
+        std::cout << "Single precision pair kernel: " \
+            << NBodyForceEngine::ForceEngineName(engine) << std::endl;
+    }
+
+    return this->force_float;
+}
+// Sets up carrier log decimation and ROI from options
+void PDelay::SetOutputPolicy()
+{
+    if (out_fraction <= FP_T(0.0) || out_fraction > FP_T(1.0)) {
+        std::cerr << "Error!! --out_fraction must be in (0, 1]!!" << std::endl;
+        exit(-1);
+    }
+
+    this->OutPolicy.every_steps = out_every;
+    this->OutPolicy.every_time = out_dt;
+    this->OutPolicy.fraction = out_fraction;
+    this->OutPolicy.electrode_dist = out_electrode;
+    if (!out_roi_str.empty()) {
+        this->OutPolicy.use_roi = true;
+        this->OutPolicy.roi = ParseBox(out_roi_str);
+    }
+
+    if (this->OutPolicy.IsOn())
+        std::cout << "Carrier log decimation/ROI filters are on." << std::endl;
+}
+void PDelay::SetCheckpointFile()
+{
+    if (!this->checkpoint_every && \
+        fp_equal(this->checkpoint_minutes, FP_T(0.0))) {
+        this->checkpoint_file.clear();
+        return;
+    }
+
+    // Default: <input basename>.ckpt at current directory.
+    if (this->checkpoint_file.empty()) {
+        auto input_name = fs::path(this->input_file).filename().string();
+        this->checkpoint_file = \
+            input_name.substr(0, input_name.find_first_of(".")) + ".ckpt";
+    }
+
+    std::cout << "Writing checkpoints to: " \
+        << this->checkpoint_file << std::endl;
+}
+int PDelay::SetDBSchema(const std::string& new_db_schema)
+{
+    if (str_to_lower(new_db_schema) == "single") {
+        this->vis_mode = NBV_OMODE_SQLITE3_TS;
+        std::cout << "Setting up carrier database: single time indexed table" << std::endl;
+    }
+    else if (str_to_lower(new_db_schema) == "perstep") {
+        this->vis_mode = NBV_OMODE_SQLITE3;
+    }
+    else {
+        std::cout << "Error!! Wrong database schema!!" << std::endl;
+        std::cout << "Use one of: PerStep, Single" << std::endl;
+        exit(-1);
+    }
+
+    return this->vis_mode;
+}
 
 /**
  *
@@ -72,6 +72,45 @@ private:
     bool c_log;                // Generate carrier log.
     std::string bias_str;      // Bias input string
     std::string dimension_str; // Dimension string
+    std::string tree_walk_str; // Octree walk mode string
+    unsigned int tree_walk;    // Octree walk mode (Carrier or Group)
+    unsigned int group_size;   // Max. carriers per group in Group walk mode
+    std::string force_engine_str; // Force engine string
+    unsigned int force_engine; // Force engine (Native, Direct, Tree, Mesh or Auto)
+    std::string force_float_str; // Single precision force engines string
+    unsigned int force_float;  // Single precision force engines (bit per engine)
+    fp_t tree_alpha;           // Octree opening threshold alpha
+    uint64_t leaf_size;        // Max. carriers per octree leaf
+    uint64_t tree_max_depth;   // Octree depth limit
+    std::string force_check_file; // Force accuracy csv filename, empty disables
+    uint64_t force_check_every;   // Force accuracy check every N steps
+    uint64_t force_check_samples; // Carriers sampled per force accuracy check
+    fp_t force_tol;            // Target relative rms force error, 0 disables alpha tuning
+    fp_t capture_radius;       // Electron-hole capture radius (um), 0 disables
+    fp_t fast_forward;         // Max. space charge/drift force to fast forward, 0 disables
+    uint64_t reorder_every;    // Sort carriers along Morton curve every N steps, 0 disables
+    fp_t reorder_disorder;     // Sort if this fraction of neighbours is out of order, 0 disables
+    uint64_t omp_serial_below; // OpenMP regions with fewer items run serial
+    uint64_t omp_min_items;    // Min. items per OpenMP thread
+    double omp_min_work;       // Min. measured work per OpenMP thread (us)
+    unsigned int event_echo;   // Max. carrier events echoed to console per step, 0 disables
+    std::string db_schema_str; // Carrier database schema string (PerStep or Single)
+    uint64_t checkpoint_every; // Write checkpoint every N steps, 0 disables
+    fp_t checkpoint_minutes;   // Write checkpoint every M minutes, 0 disables
+    std::string checkpoint_file; // Checkpoint filename
+    std::string restart_file;  // Restart from this checkpoint file
+    uint64_t out_every;        // Write carrier log every N steps, 0 disables
+    fp_t out_dt;               // Write carrier log every dt (s), 0 disables
+    fp_t out_fraction;         // Fraction of carriers written to carrier log
+    std::string out_roi_str;   // Carrier log region of interest string
+    fp_t out_electrode;        // Write carriers within this distance (um) of electrodes, 0 disables
+    CarrierOutputPolicy OutPolicy; // Carrier log decimation and ROI filters
+    std::string current_file;  // Induced current csv filename, empty disables
+    std::string stats_prefix;  // Streaming statistics output prefix, empty disables
+    fp_t stats_t_bin;          // Collection time histogram bin (s)
+    fp_t stats_r_bin;          // Collection radius histogram bin (um)
+    std::string profile_prefix; // Profiler output prefix, empty disables
+    std::string profile_hw_str; // Use hardware counters in profiler (True or False)
 
     enum sim_modes { onetoone, octree }; // Supported simulation modes.
     enum algorithm_modes { oneshot, skdk, sdkd }; // Supported algorithms.
@@ -107,7 +146,7 @@ private:
     std::string GetPath(const char* some_file_path);
     std::string GetFullPath(std::string some_file_path);
     std::string GetFullPath(const char* some_file_path);
-    
+
     // Parse options
     //
     // The cxxopts::Options was Adopted from...
@@ -170,6 +209,12 @@ public:
     bool SetInputFile(const char* new_input_file);
     int SetSimMode(std::string mode);
     int SetSimMode(const char* new_sim_mode);
+    int SetTreeWalk(const std::string& new_tree_walk);
+    int SetForceEngine(const std::string& new_force_engine);
+    int SetForceFloat(const std::string& new_force_float);
+    int SetDBSchema(const std::string& new_db_schema);
+    void SetCheckpointFile();
+    void SetOutputPolicy();
 
     /**
      *
@@ -192,30 +237,68 @@ public:
     PDelay() : \
         sim_mode({}),
         algorithm({}),
-        sim_mode_i(octree),
-        sim_algorithm_i(oneshot),
         self_path("."),
         input_file({}),
         cr_file({}),
+        database_file(MAT_DB_FILE),
+        continued(false),
+        force_delta_t(false),
+        vis_mode(NBV_OMODE_SQLITE3),
+        def_unit(um),
         c_log(true),
         bias_str({}),
         dimension_str({}),
-        database_file(MAT_DB_FILE),
-        vis_mode(NBV_OMODE_SQLITE3),
-        force_delta_t(false),
+        tree_walk_str({}),
+        tree_walk(BHT_WALK_CARRIER),
+        group_size(32),
+        force_engine_str({}),
+        force_engine(FENG_NATIVE),
+        force_float_str({}),
+        force_float(0),
+        tree_alpha(FP_T(0.5)),
+        leaf_size(BHTREE_LEAF_SIZE_DEF),
+        tree_max_depth(BHTREE_MAX_DEPTH_DEF),
+        force_check_file({}),
+        force_check_every(ACC_EVERY_DEF),
+        force_check_samples(ACC_SAMPLES_DEF),
+        force_tol(FP_T(0.0)),
+        capture_radius(FP_T(0.0)),
+        fast_forward(FP_T(0.0)),
+        reorder_every(0),
+        reorder_disorder(REORDER_DISORDER_DEF),
+        omp_serial_below(OMP_SERIAL_BELOW_DEF),
+        omp_min_items(OMP_MIN_ITEMS_DEF),
+        omp_min_work(OMP_MIN_WORK_US_DEF),
+        event_echo(EVENT_ECHO_DEF),
+        db_schema_str({}),
+        checkpoint_every(0),
+        checkpoint_minutes(FP_T(0.0)),
+        checkpoint_file({}),
+        restart_file({}),
+        out_every(0),
+        out_dt(FP_T(0.0)),
+        out_fraction(FP_T(1.0)),
+        out_roi_str({}),
+        out_electrode(FP_T(0.0)),
+        current_file({}),
+        stats_prefix({}),
+        stats_t_bin(STAT_T_BIN_DEF),
+        stats_r_bin(STAT_R_BIN_DEF),
+        profile_prefix({}),
+        profile_hw_str({}),
+        sim_mode_i(octree),
+        sim_algorithm_i(oneshot),
+        NBodyRunner(nullptr),
+        NBodyOctreeRunner(nullptr),
         doping_concentration(DOPING_CONC),
-        delta_t(FP_T(0.0)),
-        temperature(FP_T(300.0)),
-        def_unit(um),
+        num_of_procs(cpuNUM()),
         SensorChunk(DIM_BOX),
         DetBias(BIAS_DEF),
         DetMaterial(MATERIAL),
         InsulatorMaterial({}),
-        continued(false),
-        num_of_procs(cpuNUM()),
-        options({}),
-        NBodyRunner(nullptr),
-        NBodyOctreeRunner(nullptr)
+        delta_t(FP_T(0.0)),
+        temperature(FP_T(300.0)),
+        options({})
     {
     }
 
@@ -0,0 +1,187 @@
+/**
+ *
+ * pdgen.cc
+ *
+ * Synthetic carrier cloud generator for scaling studies.
+ *
+ * Writes either an input tarball in the Geant4 schema
+ * (flagParticle,flagProcess,x,y,z,...) or a binary cache, which is
+ * a step 0 checkpoint that pdelay loads directly (pdelay cloud.ckpt)
+ * without parsing any text.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+#include "cxxopts.hpp" // https://github.com/jarro2783/cxxopts
+#include "sim_checkpoint.h"
+#include "synth_cloud.h"
+#include "sim_dimension.h"
+
+// Carrier count limits
+static const uint64_t GEN_N_MIN = 2;
+static const uint64_t GEN_N_MAX = 100000000;
+
+/**
+ *
+ * Binary cache writer: a checkpoint at step 0.
+ *
+**/
+class GenCache : public virtual NBodyCheckpoint
+{
+public:
+    int Write(const std::string& fname, CarrierList&& carriers)
+    {
+        this->Carriers = std::move(carriers);
+        this->num_elec = 0;
+        this->num_hole = 0;
+        for (auto& carrier : this->Carriers) {
+            if (carrier->GetTypeI() == CARR_T_ELECTRON) ++this->num_elec;
+            else ++this->num_hole;
+        }
+        this->sim_step = 0;
+        this->elapsed_time = FP_T(0.0);
+        this->delta_t = FP_T(0.0);
+        this->forced_delta_t = false;
+
+        return this->WriteCheckpoint(fname);
+    }
+
+    GenCache() {;}
+    virtual ~GenCache() {;}
+};
+
+/**
+ *
+ * The generator
+ *
+**/
+class PDGen
+{
+private:
+    SynthCloudSpec spec;
+    uint64_t n_carriers;
+    std::string output_file;
+
+public:
+    int ParseOptions(int argc, char* argv[]);
+    int Run();
+
+    PDGen() : \
+        spec({}),
+        n_carriers(0),
+        output_file({})
+    {;}
+    virtual ~PDGen() {;}
+};
+
+// Parse options
+int PDGen::ParseOptions(int argc, char* argv[])
+{
+    std::string n_str, geometry_str, center_str, dimension_str;
+    fp_t sigma, blob_spread;
+    uint64_t n_blobs, seed;
+
+    auto options = cxxopts::Options("PDGen", "Synthetic carrier cloud generator");
+    options.add_options()
+        ("h,help", "Shows help message")
+        ("n,carriers", "Number of carriers (electrons + holes), i.e. 1e5", cxxopts::value<std::string>(n_str)->default_value("1e3"))
+        ("g,geometry", "Cloud geometry (Point, Line, Gaussian, Uniform)", cxxopts::value<std::string>(geometry_str)->default_value("Gaussian"))
+        ("center", "Cloud center <x>:<y>:<z> (um)", cxxopts::value<std::string>(center_str)->default_value("0:0:250"))
+        ("sigma", "Blob or track radial spread (um)", cxxopts::value<fp_t>(sigma)->default_value("5"))
+        ("blobs", "Number of Gaussian blobs", cxxopts::value<uint64_t>(n_blobs)->default_value("1"))
+        ("blob_spread", "Spread of Gaussian blob centers (um)", cxxopts::value<fp_t>(blob_spread)->default_value("50"))
+        ("dim", "Sensor box x<x_start>:<x_end>y<y_start>:<y_end>z<z_start>:<z_end>", cxxopts::value<std::string>(dimension_str)->default_value("x-10000:10000y-10000:10000z0:500"))
+        ("seed", "Random seed", cxxopts::value<uint64_t>(seed)->default_value(std::to_string(SYNTH_SEED_DEF)))
+        ("o,output", "Output: .tar.bz2, .tar.gz, .tar (tarball) or .ckpt (binary cache)", cxxopts::value<std::string>(output_file))
+        ;
+
+    options.parse_positional(std::vector<std::string>{ "output" });
+    options.parse(argc, argv);
+
+    if (options.count("help") || this->output_file.empty()) {
+        std::cout << options.help({ "" }) << std::endl;
+        exit(0);
+    }
+
+    this->n_carriers = static_cast<uint64_t>(str_to_num<double>(n_str));
+    if (this->n_carriers < GEN_N_MIN || this->n_carriers > GEN_N_MAX) {
+        std::cerr << "Error!! Number of carriers must be in [" \
+            << GEN_N_MIN << ", " << GEN_N_MAX << "]!!" << std::endl;
+        exit(-1);
+    }
+
+    auto geometry = SynthGeometryFromStr(geometry_str);
+    if (geometry < 0) {
+        std::cerr << "Error!! Wrong geometry: " << geometry_str << std::endl;
+        std::cerr << "Use one of: Point, Line, Gaussian, Uniform" << std::endl;
+        exit(-1);
+    }
+
+    std::vector<std::string> center_tok;
+    boost::algorithm::split(center_tok, center_str, boost::algorithm::is_any_of(":"));
+    if (center_tok.size() != 3) {
+        std::cerr << "Error!! --center must be <x>:<y>:<z>!!" << std::endl;
+        exit(-1);
+    }
+
+    // Each deposit makes an electron-hole pair.
+    this->spec.n_deposits = (this->n_carriers + 1) / 2;
+    this->spec.geometry = static_cast<uint8_t>(geometry);
+    this->spec.center = Loc{
+        str_to_num<fp_t>(center_tok[0]),
+        str_to_num<fp_t>(center_tok[1]),
+        str_to_num<fp_t>(center_tok[2]) };
+    this->spec.sigma = sigma;
+    this->spec.n_blobs = n_blobs;
+    this->spec.blob_spread = blob_spread;
+    this->spec.box = ParseBox(dimension_str);
+    this->spec.seed = seed;
+
+    return 0;
+}
+
+// Generates and writes the cloud
+int PDGen::Run()
+{
+    auto deposits = SynthDeposits(this->spec);
+    std::cout << "Generated " << deposits.size() << " deposits (" \
+        << deposits.size()*2 << " carriers)" << std::endl;
+
+    int ret = 0;
+    if (boost::algorithm::iends_with(this->output_file, ".ckpt")) {
+        Materials::MatData material;
+        auto electron_mass = material.GetSemi("Silicon", "MVTHN")*m_elec;
+        auto hole_mass = material.GetSemi("Silicon", "MVTHP")*m_elec;
+
+        GenCache cache;
+        ret = cache.Write(this->output_file,
+            SynthCarriers(deposits, electron_mass, hole_mass, this->spec.seed));
+    }
+    else {
+        ret = WriteSynthTarball(this->output_file, deposits);
+    }
+
+    if (!ret)
+        std::cout << "Written to: " << this->output_file << std::endl;
+    return ret;
+}
+
+/**
+ *
+ * The main function...
+ *
+**/
+int main(int argc, char* argv[])
+{
+    PDGen Gen;
+    Gen.ParseOptions(argc, argv);
+
+    return Gen.Run();
+}
@@ -10,6 +10,9 @@
  *
 **/
 
+#include <algorithm>
+#include <cmath>
+
 #include "CTCForce.h"
 #include "Utils.h"
 
@@ -19,7 +22,7 @@ using namespace Physics;
 //
 // Vth = sqrt(3*k_B*T/m*)
 //
-Vel CTCForce::thermal_vel(const spCarrier& carrier)
+Vel CTCForce::thermal_vel(const spCarrier& carrier, SplitMix64& rng)
 {
     // The thermal velocity comes from...
     //
@@ -34,7 +37,7 @@ Vel CTCForce::thermal_vel(const spCarrier& carrier)
         v_therm(this->temperature, carrier->GetMass());
 
     // Implementing it into a random 3D vector.
-    Vel output_Vel = UnitVec3D<fp_t>() * vel_therm;
+    Vel output_Vel = UnitVec3D<fp_t>(rng) * vel_therm;
     // note that the return value is in the unit of (m/s)
     return output_Vel;
 }
@@ -79,7 +82,8 @@ void CTCForce::Diffusion(const spCarrier& carrier, const fp_t& tau)
     auto Dt = k_B*this->temperature*Mu/q_h;
     auto DiffLen = (sqrt(Dt*tau) / FP_T(100.0)) * this->len_scale_f; // Matching to CGS with / FP_T(100)
 
-    auto DiffusedPos = UnitVec3D<fp_t>() * DiffLen;
+    auto rng = this->CarrierRng(carrier, RNG_STREAM_DIFFUSION);
+    auto DiffusedPos = UnitVec3D<fp_t>(rng) * DiffLen;
 
     carrier->AdjPosDelta(DiffusedPos);
 
@@ -99,7 +103,8 @@ void CTCForce::MFPAdj(spCarrier& carrier, const fp_t& tau)
 {
     // Obtain 3D thermal velocity.
     //
-    fp_t mean_free_time = uniform_rand<fp_t>(1e-14, 1e-13);
+    auto rng = this->CarrierRng(carrier, RNG_STREAM_MFP);
+    fp_t mean_free_time = uniform_rand<fp_t>(rng, 1e-14, 1e-13);
     //
     // thermal velocity * meal_free_time --> random movement.
     //
@@ -111,7 +116,7 @@ void CTCForce::MFPAdj(spCarrier& carrier, const fp_t& tau)
     if (brownian_motions > 0) {
         for (int i = 0; i<brownian_motions; ++i) {
             carrier->AdjPosDelta(
-                this->thermal_vel(carrier)*this->len_scale_f*mean_free_time);
+                this->thermal_vel(carrier, rng)*this->len_scale_f*mean_free_time);
         }
     }
 
@@ -148,7 +153,7 @@ Force CTCForce::DriftForce(const spCarrier& carrier)
 }
 
 // Coulomb force calculation (returns MKS)
-Force CTCForce::CoulombForce(spCarrier& carrier, spCarrier& other)
+Force CTCForce::CoulombForce(const spCarrier& carrier, const spCarrier& other)
 {
     // Safeguard... if carrier == other... then just return dummy.
     if (carrier->GetPos() == other->GetPos())
@@ -180,4 +185,163 @@ Force CTCForce::CoulombForce(spCarrier& carrier, spCarrier& other)
     return f_direction * static_cast<fp_t>(force);
 }
 
+// Sources of the pair kernel in Real
+// --> fp_t: positions and charges as they are
+// --> float: offsets from the anchor, charges in q_h (list.to_float)
+template <typename Real>
+struct PairSources {
+    typedef fp_t src_t;
+    typedef Real acc_t;
+    static size_t size(const InteractionList& list) { return list.size(); }
+    static const src_t* x(const InteractionList& list) { return list.x.data(); }
+    static const src_t* y(const InteractionList& list) { return list.y.data(); }
+    static const src_t* z(const InteractionList& list) { return list.z.data(); }
+    static const src_t* q(const InteractionList& list) { return list.q.data(); }
+    static Loc origin(const InteractionList&) { return Loc{}; }
+    static fp_t q_unit() { return FP_T(1.0); }
+};
+
+template <>
+struct PairSources<float> {
+    typedef float src_t;
+    typedef double acc_t;
+    static size_t size(const InteractionList& list) { return list.fq.size(); }
+    static const src_t* x(const InteractionList& list) { return list.fx.data(); }
+    static const src_t* y(const InteractionList& list) { return list.fy.data(); }
+    static const src_t* z(const InteractionList& list) { return list.fz.data(); }
+    static const src_t* q(const InteractionList& list) { return list.fq.data(); }
+    static Loc origin(const InteractionList& list) { return list.anchor; }
+    static fp_t q_unit() { return q_h; }
+};
+
+// Coulomb force from a shared interaction list (returns MKS)
+//
+// Same physics as CoulombForce, but sources are plain arrays so the
+// inner loop (coulomb_sum) can be vectorized. Sources within Debye
+// length (including the carrier itself) are skipped.
+//
+// In float, offsets from the list's anchor are small next to the
+// positions, so differences keep about 1e-7 relative precision.
+//
+// out(i, fx, fy, fz) takes the force on group[i] in Acc.
+//
+template <typename Real, typename Out>
+static void coulomb_group(
+    CTCForce& ctc, const InteractionList& list, const CarrierVector& group,
+    Out& out)
+{
+    typedef PairSources<Real> Src;
+    typedef typename Src::acc_t Acc;
+
+    if (group.empty()) return;
+
+    const size_t n_src = Src::size(list);
+    const auto* src_x = Src::x(list);
+    const auto* src_y = Src::y(list);
+    const auto* src_z = Src::z(list);
+    const auto* src_q = Src::q(list);
+    const auto origin = Src::origin(list);
+
+    // Debye length in um (same for electrons and holes)
+    fp_t debye_um = ctc.DebyeLength(group.front())*ctc.len_scale_f;
+    const Real debye_sq = static_cast<Real>(debye_um*debye_um);
+
+    // Positions are in um --> scale up to MKS
+    fp_t scale = k_e*Src::q_unit()*ctc.len_scale_f*ctc.len_scale_f;
+
+    for (size_t i = 0; i < group.size(); ++i) {
+        auto& carrier = group[i];
+        auto pos = carrier->GetPos();
+        Acc fx, fy, fz;
+        coulomb_sum<Real, Acc>(
+            src_x, src_y, src_z, src_q, n_src,
+            static_cast<Real>(pos.x - origin.x),
+            static_cast<Real>(pos.y - origin.y),
+            static_cast<Real>(pos.z - origin.z),
+            debye_sq, fx, fy, fz);
+
+        auto q_scale = static_cast<Acc>(carrier->GetCharge()*scale);
+        out(i, fx*q_scale, fy*q_scale, fz*q_scale);
+    }
+}
+
+// Adds group forces to the carriers
+struct GroupForceToCarriers {
+    const CarrierVector& group;
+
+    template <typename Acc>
+    void operator()(
+        const size_t& i, const Acc& fx, const Acc& fy, const Acc& fz)
+    {
+        this->group[i]->AddForce(Force{
+            static_cast<fp_t>(fx),
+            static_cast<fp_t>(fy),
+            static_cast<fp_t>(fz) });
+    }
+};
+
+// Stores group forces in a buffer (x, y, z per carrier)
+struct GroupForceToBuffer {
+    std::vector<double>& f;
+
+    template <typename Acc>
+    void operator()(
+        const size_t& i, const Acc& fx, const Acc& fy, const Acc& fz)
+    {
+        this->f[3*i] = static_cast<double>(fx);
+        this->f[3*i + 1] = static_cast<double>(fy);
+        this->f[3*i + 2] = static_cast<double>(fz);
+    }
+};
+
+template <typename Real>
+void CTCForce::CoulombForceGroupT(
+    const InteractionList& list, CarrierVector& group)
+{
+    GroupForceToCarriers out{ group };
+    coulomb_group<Real>(*this, list, group, out);
+}
+
+// Pair precisions a run can pick
+template void Physics::CTCForce::CoulombForceGroupT<float>(
+    const InteractionList& list, CarrierVector& group);
+template void Physics::CTCForce::CoulombForceGroupT<fp_t>(
+    const InteractionList& list, CarrierVector& group);
+
+// Same in precision picked at run time
+void CTCForce::CoulombForceGroup(
+    const InteractionList& list, CarrierVector& group,
+    const unsigned int& prec)
+{
+    switch (prec) {
+    case PAIR_PREC_FLOAT:
+        this->CoulombForceGroupT<float>(list, group);
+        break;
+    default:
+        this->CoulombForceGroupT<fp_t>(list, group);
+        break;
+    }
+}
+
+// Group forces into a buffer, carriers untouched
+void CTCForce::CoulombForceGroupSum(
+    const InteractionList& list, const CarrierVector& group,
+    const unsigned int& prec, std::vector<double>& f)
+{
+    f.assign(3*group.size(), 0.0);
+    GroupForceToBuffer out{ f };
+    if (prec == PAIR_PREC_FLOAT)
+        coulomb_group<float>(*this, list, group, out);
+    else
+        coulomb_group<fp_t>(*this, list, group, out);
+}
 
+// Pair kernel precision name
+const char* PairPrecisionName(const unsigned int& prec)
+{
+    switch (prec) {
+    case PAIR_PREC_FLOAT: return "Single";
+    case PAIR_PREC_DOUBLE: return "Double";
+    default: return "Unknown";
+    }
+}
@@ -20,6 +20,8 @@
 #include "typedefs.h"
 #include "materials.h"
 #include "sim_space.h"
+#include "interaction_list.h"
+#include "coulomb_kernel.h"
 
 namespace Physics {
 
@@ -30,7 +32,8 @@ public:
     // Returns effective mass of electron/holes of silicon.
     // fp_t eff_mass_si(spCarrier carrier);
     // Returns thermal velocity with effective mass
-    Vel thermal_vel(const spCarrier& carrier);
+    // --> direction drawn from the given carrier stream.
+    Vel thermal_vel(const spCarrier& carrier, SplitMix64& rng);
 
     // Calculate Debye length for a carrier
     fp_t DebyeLength(const spCarrier& carrier);
@@ -47,7 +50,35 @@ public:
     Force DriftForce(const spCarrier& carrier);
 
     // Carrier to Carrier interaction.
-    Force CoulombForce(spCarrier& carrier, spCarrier& other);
+    Force CoulombForce(const spCarrier& carrier, const spCarrier& other);
+
+    // Carrier to interaction list (a whole group at once) with pair
+    // arithmetic in Real: float or fp_t (instantiated in CTCForce.cc).
+    // Float works around list's anchor (call
+    // list.to_float first), partial sums of each tile added up in double.
+    // --> Adds up Coulomb force to every carrier in the group.
+    template <typename Real>
+    void CoulombForceGroupT(
+        const InteractionList& list, CarrierVector& group);
+
+    // Same in precision picked at run time (PAIR_PREC_*)
+    void CoulombForceGroup(
+        const InteractionList& list, CarrierVector& group,
+        const unsigned int& prec);
+
+    void CoulombForceGroup(
+        const InteractionList& list, CarrierVector& group)
+    { this->CoulombForceGroupT<fp_t>(list, group); }
+
+    void CoulombForceGroupF(
+        const InteractionList& list, CarrierVector& group)
+    { this->CoulombForceGroupT<float>(list, group); }
+
+    // Same, but forces (x, y, z per carrier, in the precision's sum
+    // type) go to f and the carriers are left alone.
+    void CoulombForceGroupSum(
+        const InteractionList& list, const CarrierVector& group,
+        const unsigned int& prec, std::vector<double>& f);
 
 	// Constructors and Destructors
 	CTCForce() {;}
@@ -57,5 +88,8 @@ public:
 
 }; /* namespace Physics */
 
+// Pair kernel precision name (Single, Double)
+const char* PairPrecisionName(const unsigned int& prec);
+
 
 #endif /* Include guard */
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ *
+ * coulomb_kernel.h
+ *
+ * Coulomb pair kernel templated on arithmetic precision
+ *
+ * Adds up q_j*(r_j - r)/|r_j - r|^3 over a source list for one target,
+ * skipping sources within the Debye length. Real is the precision of
+ * the pair arithmetic, Acc the one tile sums are added up in:
+ *
+ * - <float, double>: single precision offsets from the list anchor
+ * - <double, double>: source arrays as they are
+ *
+ * Being a header template, every precision gets its own inlined loop.
+ * CTCForce instantiates the group kernel for both and the force
+ * engines pick one per engine at run time.
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __coulomb_kernel_h__
+#define __coulomb_kernel_h__
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include "fputils.h"
+
+// Pair kernel precisions
+static const unsigned int PAIR_PREC_FLOAT = 0;
+static const unsigned int PAIR_PREC_DOUBLE = 1;
+static const unsigned int PAIR_N_PRECS = 2;
+
+// Sources per partial sum in pair precision
+static const size_t CTC_FLOAT_TILE = 256;
+
+// Sum over sources [0, n) for target (px, py, pz)
+// --> Sources and target must share the origin (i.e. the anchor).
+template <typename Real, typename Acc, typename Src>
+inline void coulomb_sum(
+    const Src* sx, const Src* sy, const Src* sz, const Src* sq,
+    const size_t& n, const Real& px, const Real& py, const Real& pz,
+    const Real& debye_sq, Acc& fx, Acc& fy, Acc& fz)
+{
+    fx = Acc(0); fy = Acc(0); fz = Acc(0);
+#ifdef __COMPENSATED__
+    Acc ax = Acc(0), ay = Acc(0), az = Acc(0);
+#endif
+
+    for (size_t j0 = 0; j0 < n; j0 += CTC_FLOAT_TILE) {
+        const size_t j1 = std::min(j0 + CTC_FLOAT_TILE, n);
+        Real tx = Real(0), ty = Real(0), tz = Real(0);
+#ifdef __COMPENSATED__
+        Real cx = Real(0), cy = Real(0), cz = Real(0);
+#pragma omp simd reduction(+:tx,ty,tz,cx,cy,cz)
+#elif !defined(__MULTIPRECISION__)
+#pragma omp simd reduction(+:tx,ty,tz)
+#endif
+        for (size_t j = j0; j < j1; ++j) {
+            Real dx = static_cast<Real>(sx[j]) - px;
+            Real dy = static_cast<Real>(sy[j]) - py;
+            Real dz = static_cast<Real>(sz[j]) - pz;
+            Real r_sq = dx*dx + dy*dy + dz*dz;
+            // Evaluate at Debye length and mask the inverse, so that
+            // no load or division ends up in a branch (keeps it SIMD).
+            Real r_c = (r_sq > debye_sq) ? r_sq : debye_sq;
+            Real inv = Real(1) / (r_c*std::sqrt(r_c));
+            inv = (r_sq > debye_sq) ? inv : Real(0);
+            Real w = static_cast<Real>(sq[j])*inv;
+#ifdef __COMPENSATED__
+            fp_two_sum_add<Real>(tx, cx, w*dx);
+            fp_two_sum_add<Real>(ty, cy, w*dy);
+            fp_two_sum_add<Real>(tz, cz, w*dz);
+#else
+            tx += w*dx;
+            ty += w*dy;
+            tz += w*dz;
+#endif
+        }
+
+#ifdef __COMPENSATED__
+        fp_kahan_add<Acc>(fx, ax, static_cast<Acc>(tx) + static_cast<Acc>(cx));
+        fp_kahan_add<Acc>(fy, ay, static_cast<Acc>(ty) + static_cast<Acc>(cy));
+        fp_kahan_add<Acc>(fz, az, static_cast<Acc>(tz) + static_cast<Acc>(cz));
+#else
+        fx += static_cast<Acc>(tx);
+        fy += static_cast<Acc>(ty);
+        fz += static_cast<Acc>(tz);
+#endif
+    }
+}
+
+#endif /* Include guard */
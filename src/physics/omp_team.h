@@ -0,0 +1,138 @@
+/**
+ *
+ * omp_team.h
+ *
+ * OpenMP team size policy for per step parallel regions.
+ *
+ * Near the end of a run only tens or hundreds of carriers are left,
+ * and waking up every thread costs more than the work. Each region
+ * asks for a team size for its item count:
+ *
+ * - fewer than serial_below items: runs on the calling thread only
+ * - otherwise at least min_items items per thread, and, once the
+ *   region has been timed, at least min_work_us of work per thread.
+ *
+ * The cost per item of every region is measured as it runs (thread
+ * seconds per item, moving average).
+ *
+ * Written by Taylor Shin
+ *
+**/
+
+#ifndef __omp_team_h__
+#define __omp_team_h__
+
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Parallel regions with their own cost history
+enum OmpRegion : uint8_t {
+    OMP_R_KICK = 0,
+    OMP_R_DRIFT,
+    OMP_R_REMOVE,
+    OMP_R_RECOMB,
+    OMP_R_OUTPUT,
+    OMP_R_N
+};
+
+// Defaults
+static const uint64_t OMP_SERIAL_BELOW_DEF = 64;
+static const uint64_t OMP_MIN_ITEMS_DEF = 16;
+static const double OMP_MIN_WORK_US_DEF = 20.0;
+
+// Weight of a new measurement in per item cost
+static const double OMP_COST_EMA = 0.25;
+
+class OmpTeamPolicy
+{
+public:
+    uint64_t serial_below;  // Serial if fewer items (0: never)
+    uint64_t min_items;     // Min. items per thread
+    double min_work_us;     // Min. measured work per thread (us, 0: off)
+
+    // Measured thread time per item (ns), 0: not yet measured
+    double item_ns[OMP_R_N];
+
+    // Team size for n items of a region
+    unsigned int Team(const OmpRegion& region, const uint64_t& n) const
+    {
+        unsigned int max_team = 1;
+#ifdef _OPENMP
+        max_team = static_cast<unsigned int>(omp_get_max_threads());
+#endif
+        if (max_team <= 1 || n < this->serial_below) return 1;
+
+        uint64_t team = max_team;
+        if (this->min_items)
+            team = std::min<uint64_t>(team, n / this->min_items);
+        if (this->min_work_us > 0.0 && this->item_ns[region] > 0.0) {
+            auto work_us = this->item_ns[region]*static_cast<double>(n)*1e-3;
+            team = std::min<uint64_t>(
+                team, static_cast<uint64_t>(work_us / this->min_work_us));
+        }
+
+        return static_cast<unsigned int>(std::max<uint64_t>(team, 1));
+    }
+
+    // Adds a measurement: team threads took seconds for n items.
+    void Record(
+        const OmpRegion& region, const uint64_t& n,
+        const unsigned int& team, const double& seconds)
+    {
+        if (!n) return;
+        auto ns = seconds*1e9*static_cast<double>(team)/static_cast<double>(n);
+        auto& cost = this->item_ns[region];
+        cost = cost > 0.0 ? (1.0 - OMP_COST_EMA)*cost + OMP_COST_EMA*ns : ns;
+    }
+
+    void Set(
+        const uint64_t& new_serial_below,
+        const uint64_t& new_min_items,
+        const double& new_min_work_us)
+    {
+        this->serial_below = new_serial_below;
+        this->min_items = new_min_items;
+        this->min_work_us = new_min_work_us;
+    }
+
+    OmpTeamPolicy() : \
+        serial_below(OMP_SERIAL_BELOW_DEF),
+        min_items(OMP_MIN_ITEMS_DEF),
+        min_work_us(OMP_MIN_WORK_US_DEF)
+    {
+        std::fill(this->item_ns, this->item_ns + OMP_R_N, 0.0);
+    }
+    virtual ~OmpTeamPolicy() {;}
+};
+
+// Picks the team of a region and times it until end of scope.
+class OmpTeamScope
+{
+private:
+    OmpTeamPolicy& policy;
+    OmpRegion region;
+    uint64_t n;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    unsigned int team;
+
+    OmpTeamScope(OmpTeamPolicy& p, const OmpRegion& r, const uint64_t& n_items) : \
+        policy(p), region(r), n(n_items),
+        start(std::chrono::steady_clock::now()),
+        team(p.Team(r, n_items))
+    {;}
+    virtual ~OmpTeamScope()
+    {
+        this->policy.Record(this->region, this->n, this->team,
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - this->start).count());
+    }
+};
+
+#endif /* Include guard */
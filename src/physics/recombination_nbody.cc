@@ -10,6 +10,7 @@
 **/
 
 #include "recombination_nbody.h"
+#include "Utils.h"
 
 
 using namespace Physics;
@@ -83,7 +84,6 @@ void Recombination_NBody::BulkRecombination()
         static_cast<uint64_t>(
             round(this->recomb_total*vol_mat*this->delta_t));
 
-    auto carr_it = std::begin(this->Carriers);
     auto num_carrs = \
         static_cast<uint64_t>(this->Carriers.size());
     std::cout << "*** Recombination Rate: " \
@@ -91,102 +91,183 @@ void Recombination_NBody::BulkRecombination()
         << " /current volume /" << this->delta_t \
         << " second(s) " \
         << " ***" << std::endl;
+    this->init_rem();
     if (num_of_recombined_carr >= num_carrs) {
         std::cerr << "Lost all carriers in the void!!" \
             << std::endl << std::endl;
-        for (carr_it;
-            carr_it!=std::end(this->Carriers); ++carr_it) {
-            this->add_to_rem(carr_it->second);
-            this->write_mat_recomb_carrier_info(carr_it->second);
+        for (uint64_t i = 0; i < num_carrs; ++i) {
+            this->add_to_rem(i);
+            this->write_mat_recomb_carrier_info(this->Carriers[i]);
         }
     }
-    else {
-        for (auto i=0; i<num_of_recombined_carr; ++i) {
-            carr_it = std::begin(this->Carriers);
-            std::advance(carr_it, rand() % num_of_recombined_carr);
-            this->add_to_rem(carr_it->second);
-            this->write_mat_recomb_carrier_info(carr_it->second);
+    else if (num_of_recombined_carr) {
+        auto picked = sample_indices(
+            num_carrs, num_of_recombined_carr, this->sim_rng);
+        for (auto i : picked) {
+            this->add_to_rem(i);
+            this->write_mat_recomb_carrier_info(this->Carriers[i]);
         }
     }
 
     // Remove carriers as recombination
-    for (auto ctr : this->CarriersToRemove) {
-        this->remove_carr(ctr);
-    }
-    this->CarriersToRemove.clear();
+    this->remove_marked_carr();
 
     return;
 }
 
+// Cell key from a position
+//
+// Each axis gets 21 bits. Far away cells may wrap around into the same
+// key, which only adds a few more distance checks.
+//
+uint64_t Recombination_NBody::c2c_cell_key(
+    const Loc& pos, const int64_t& dx, const int64_t& dy, const int64_t& dz) const
+{
+    auto ix = static_cast<int64_t>(floor(pos.x / this->capture_radius)) + dx;
+    auto iy = static_cast<int64_t>(floor(pos.y / this->capture_radius)) + dy;
+    auto iz = static_cast<int64_t>(floor(pos.z / this->capture_radius)) + dz;
+
+    return \
+        ((static_cast<uint64_t>(ix) & 0x1FFFFF) << 42) | \
+        ((static_cast<uint64_t>(iy) & 0x1FFFFF) << 21) | \
+        (static_cast<uint64_t>(iz) & 0x1FFFFF);
+}
+
 // sub funciton of CarrToCarrRecombination (OpenMP)
+//
+// Finds the closest opposite type carrier within capture radius
+// for carriers in [istart, istart+ipoints).
+//
 void Recombination_NBody::c_to_c_sub(
     uint64_t& istart, uint64_t& ipoints)
 {
-    // auto it = std::begin(this->Carriers);
-    // auto end = std::begin(this->Carriers);
-
-    // // Advancing it and end to calculation range.
-    // std::advance(it, istart);
-    // std::advance(end, istart+ipoints);
-
-    // // Carrier-index, distance pair.
-    // std::deque<fp_t> dist_list;
-    // std::deque<uint64_t> carr_index_list;
-
-    // // Iteration!!!! --> delete a electron-hole pair which are too close.
-    // for (it; it!=end; ++it) {
-    //     auto current_carrier = it->second;
-    //     // resetting distance lists...
-    //     dist_list.clear();
-    //     carr_index_list.clear();
-    //     auto current_carrier_pos = current_carrier.GetPos();
-    //     for (auto it_o=std::begin(this->Carriers);
-    //         it_o!=std::end(this->Carriers); ++it_o) {
-    //         auto other_carrier = it_o->second;
-
-    //         // Ditch iteration for a few trivial situations
-    //         if (current_carrier == other_carrier) continue;
-    //         if (current_carrier.GetType() == other_carrier.GetType()) continue;
-
-    //         auto other_carrier_pos = other_carrier.GetPos();
-    //         auto distance = current_carrier_pos.dist(other_carrier_pos);
-
-    //         if (distance < LDBL_MIN) {
-    //             dist_list.append(distance);
-    //             carr_index_list.append(other_carrier.GetIndex());
-    //         }
-    //     } /* for (auto it_o=std::begin(this->Carriers) */
-
-    //     // Now selecte the closest one for elimination.
-
-
-    // } /* for (it; it!=end; ++it)  */
+    auto r_sq = this->capture_radius*this->capture_radius;
+
+    for (auto i = istart; i < istart + ipoints; ++i) {
+        auto& carrier = this->Carriers[i];
+        auto pos = carrier->GetPos();
+        auto type = carrier->GetTypeI();
+
+        int64_t best = -1;
+        fp_t best_dist = r_sq;
+
+        // Scan neighboring 27 cells.
+        for (auto dx = -1; dx <= 1; ++dx) {
+        for (auto dy = -1; dy <= 1; ++dy) {
+        for (auto dz = -1; dz <= 1; ++dz) {
+            auto cell = this->c2c_cell_id.find(
+                this->c2c_cell_key(pos, dx, dy, dz));
+            if (cell == this->c2c_cell_id.end()) continue;
+
+            auto c_start = this->c2c_cell_start[cell->second];
+            auto c_end = this->c2c_cell_start[cell->second + 1];
+            for (auto k = c_start; k < c_end; ++k) {
+                auto j = this->c2c_cell_items[k];
+                auto& other = this->Carriers[j];
+                if (other->GetTypeI() == type) continue;
+
+                auto rel = other->GetPos() - pos;
+                auto dist_sq = rel.x*rel.x + rel.y*rel.y + rel.z*rel.z;
+                // Ties go to the lower index to keep it deterministic.
+                if (dist_sq < best_dist || \
+                    (dist_sq == best_dist && best >= 0 && \
+                     static_cast<int64_t>(j) < best)) {
+                    best = static_cast<int64_t>(j);
+                    best_dist = dist_sq;
+                }
+            }
+        } } } /* for (auto dx = -1; dx <= 1; ++dx) */
+
+        this->c2c_partner[i] = best;
+    }
 
     return;
 }
 
 
 // Estimates Carrier to Carrier Recombination
+//
+// Electron-hole pairs within capture radius recombine. Carriers are
+// binned into a cell list with cell size of the capture radius, so
+// partners can only be found in 27 neighboring cells. A pair recombines
+// only if they are each other's closest partner, so every carrier ends
+// up in at most one pair regardless of thread scheduling.
+//
 void Recombination_NBody::CarrToCarrRecombination()
 {
-    // With OpenMP
-// #ifdef _OPENMP
-//     uint64_t ith, nth, ipoints, istart, npoints;
-//     #pragma omp parallel default(shared) private(ith, nth, ipoints, istart)
-//     {
-//     npoints = this->Carriers.size();
-//     ith     = omp_get_thread_num();
-//     nth     = omp_get_num_threads();
-//     ipoints = npoints / nth;
-//     istart = ith * ipoints;
-//     if (ith == npoints-1) ipoints = npoints - istart;
-//     this->c_to_c_sub(istart, ipoints);
-
-//     } /* #pragma omp parallel default(shared) private(ith, nth, ipoints, istart) */
-// #else
-//     // Without OpenMP
-
-// #endif /* #ifdef _OPENMP */
+    if (!(this->capture_radius > FP_T(0.0))) return;
+    if (!this->num_elec || !this->num_hole) return;
+
+    uint64_t n_carr = this->Carriers.size();
+
+    // Binning (counting sort by cell)
+    this->c2c_cell_id.clear();
+    this->c2c_cell_of.resize(n_carr);
+    std::vector<uint64_t> cell_count;
+    for (uint64_t i = 0; i < n_carr; ++i) {
+        auto key = this->c2c_cell_key(this->Carriers[i]->GetPos());
+        auto found = this->c2c_cell_id.find(key);
+        if (found == this->c2c_cell_id.end()) {
+            found = this->c2c_cell_id.emplace(key, cell_count.size()).first;
+            cell_count.push_back(0);
+        }
+        this->c2c_cell_of[i] = found->second;
+        cell_count[found->second]++;
+    }
+
+    this->c2c_cell_start.assign(cell_count.size() + 1, 0);
+    for (uint64_t c = 0; c < cell_count.size(); ++c)
+        this->c2c_cell_start[c+1] = this->c2c_cell_start[c] + cell_count[c];
+
+    this->c2c_cell_items.resize(n_carr);
+    std::vector<uint64_t> cell_fill(
+        this->c2c_cell_start.begin(), this->c2c_cell_start.end() - 1);
+    for (uint64_t i = 0; i < n_carr; ++i)
+        this->c2c_cell_items[cell_fill[this->c2c_cell_of[i]]++] = i;
+
+    // Find closest partners
+    this->c2c_partner.assign(n_carr, -1);
+#ifdef _OPENMP
+    uint64_t ith, nth, ipoints, istart, npoints;
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_RECOMB, n_carr);
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ith, nth, ipoints, istart, npoints)
+    {
+        npoints = n_carr;
+        ith = omp_get_thread_num();
+        nth = omp_get_num_threads();
+        ipoints = npoints / nth;
+        istart = ith * ipoints;
+        if (ith == nth - 1) ipoints = npoints - istart;
+        this->c_to_c_sub(istart, ipoints);
+    } /* #pragma omp parallel */
+#else
+    uint64_t istart = 0;
+    this->c_to_c_sub(istart, n_carr);
+#endif /* #ifdef _OPENMP */
+
+    // Mutual closest pairs recombine.
+    this->init_rem();
+    uint64_t recombined_pairs = 0;
+    for (uint64_t i = 0; i < n_carr; ++i) {
+        auto j = this->c2c_partner[i];
+        if (j < 0 || static_cast<uint64_t>(j) < i) continue;
+        if (this->c2c_partner[j] != static_cast<int64_t>(i)) continue;
+
+        this->write_recombination_carrier_info(
+            this->Carriers[i], this->Carriers[j]);
+        this->add_to_rem(i);
+        this->add_to_rem(j);
+        recombined_pairs++;
+    }
+
+    if (recombined_pairs) {
+        std::cout << "*** Carrier to Carrier Recombination: " \
+            << recombined_pairs << " pair(s) ***" << std::endl;
+    }
+
+    // Remove carriers as recombination
+    this->remove_marked_carr();
 
     return;
-}
\ No newline at end of file
+}
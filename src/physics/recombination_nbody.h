@@ -16,6 +16,7 @@
 #include "sim_space.h"
 #include "sim_file_io.h"
 #include "carrier.h"
+#include "datatype_hash.h"
 
 
 namespace Physics {
@@ -38,6 +39,12 @@ public:
     void c_to_c_sub(uint64_t& istart, uint64_t& ipoints);
     void CarrToCarrRecombination();
 
+    // Capture radius for carrier to carrier recombination (um)
+    // --> zero disables carrier to carrier recombination.
+    fp_t capture_radius;
+    void SetCaptureRadius(const fp_t& new_radius)
+    { this->capture_radius = new_radius; }
+
     // Recombination Object
     Recombination NBodyRecom;
 
@@ -46,11 +53,24 @@ public:
         recomb_trap(static_cast<fp_t>(0.0)),
         recomb_auger(static_cast<fp_t>(0.0)),
         recomb_total(static_cast<fp_t>(0.0)),
+        capture_radius(static_cast<fp_t>(0.0)),
         NBodyRecom(Recombination())
     {;}
 
     virtual ~Recombination_NBody() {;}
 
+private:
+    // Cell list work space for carrier to carrier recombination.
+    std::vector<uint64_t> c2c_cell_of;      // Cell id of each carrier
+    std::vector<uint64_t> c2c_cell_start;   // Cell id -> start at c2c_cell_items
+    std::vector<uint64_t> c2c_cell_items;   // Carrier indices sorted by cell
+    std::vector<int64_t> c2c_partner;       // Closest partner (or -1)
+    DataType::Map<uint64_t, uint64_t> c2c_cell_id; // Cell key -> cell id
+
+    // Cell key from a position
+    uint64_t c2c_cell_key(const Loc& pos, const int64_t& dx=0,
+        const int64_t& dy=0, const int64_t& dz=0) const;
+
 }; /* class Recombination_NBody */
 
 
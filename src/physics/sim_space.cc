@@ -65,54 +65,100 @@ fp_t sim_space::GetVolume()
 
 
 
-// remove carrier from this->Carriers
+// Prepares removal buffers for current number of threads.
 //
-int sim_space::remove_carr(spCarrier& carrier)
+void sim_space::init_rem()
 {
-    auto Type = carrier->GetType();
-    auto erase_size = this->Carriers.erase(carrier->GetIndex());
-
-    if (!erase_size) {
-        if (Type == std::string("Electron"))
-            this->num_elec--;
-        else if (Type == std::string("Hole"))
-            this->num_hole--;
-    }
-
-    return 0;
+    uint64_t n_buffers = 1;
+#ifdef _OPENMP
+    n_buffers = omp_get_max_threads();
+#endif
+    this->CarriersToRemove.resize(n_buffers);
+    for (auto& rem_buffer : this->CarriersToRemove)
+        rem_buffer.clear();
 }
 
-// search carrier from this->Carriers
+// Removes marked carriers from this->Carriers
 //
-// returns 0 if success...
+// Marked carriers are dropped with a stable compaction: each thread
+// counts survivors of its chunk, then copies them to its offset.
+// Electron and hole counters are recounted on the way.
 //
-uint64_t sim_space::search_carr(const spCarrier& carrier, uint64_t& index)
+uint64_t sim_space::remove_marked_carr()
 {
-    // DataType::Dict implementation (which is actually a std::map)
-    auto it = this->Carriers.find(carrier->GetIndex());
-    if (it != this->Carriers.end()) {
-        index = carrier->GetIndex();
-        return 0;
+    if (this->CarriersToRemove.empty()) this->init_rem();
+
+    uint64_t n_marked = 0;
+    for (auto& rem_buffer : this->CarriersToRemove)
+        n_marked += rem_buffer.size();
+    if (!n_marked) return 0;
+
+    uint64_t n_carr = this->Carriers.size();
+    std::vector<char> rem_mask(n_carr, 0);
+    for (auto& rem_buffer : this->CarriersToRemove) {
+        for (auto carr_index : rem_buffer)
+            rem_mask[carr_index] = 1;
+        rem_buffer.clear();
     }
-    else {
-        index = -1;
-        return -1;
-    }
-}
 
-// search carrier from this->CarriersToRemove
-// returns index if success...
-//
-// --> Returning index is pointless with set or unordered_set datatype
-// So, instead, returns 0 if given carrier exists and -1 not.
-//
-uint64_t sim_space::search_rem_carr(const spCarrier& carrier)
-{
-    if (this->CarriersToRemove.find(carrier)!=
-        this->CarriersToRemove.end())
-        return 0;
-    else
-        return -1;
+    uint64_t n_chunks = 1;
+#ifdef _OPENMP
+    n_chunks = omp_get_max_threads();
+#endif
+    std::vector<uint64_t> kept(n_chunks + 1, 0);
+    std::vector<uint64_t> kept_elec(n_chunks, 0);
+    CarrierList new_carriers;
+
+#ifdef _OPENMP
+    uint64_t ith, nth, ipoints, istart;
+    OmpTeamScope omp_team(this->OmpPolicy, OMP_R_REMOVE, n_carr);
+#pragma omp parallel num_threads(omp_team.team) if(omp_team.team > 1) \
+    private(ith, nth, ipoints, istart)
+    {
+        ith = omp_get_thread_num();
+        nth = omp_get_num_threads();
+#else
+    {
+        uint64_t ith = 0, nth = 1, ipoints, istart;
+#endif
+        ipoints = n_carr / nth;
+        istart = ith * ipoints;
+        if (ith == nth - 1) ipoints = n_carr - istart;
+
+        // Count survivors
+        for (auto i = istart; i < istart + ipoints; ++i) {
+            if (rem_mask[i]) continue;
+            kept[ith + 1]++;
+            if (this->Carriers[i]->GetTypeI() == CARR_T_ELECTRON)
+                kept_elec[ith]++;
+        }
+
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+        {
+            for (uint64_t c = 0; c < nth; ++c)
+                kept[c + 1] += kept[c];
+            new_carriers.resize(kept[nth]);
+        }
+
+        // Copy survivors to their new location
+        auto dest = kept[ith];
+        for (auto i = istart; i < istart + ipoints; ++i) {
+            if (rem_mask[i]) continue;
+            new_carriers[dest++] = this->Carriers[i];
+        }
+    } /* #pragma omp parallel */
+
+    uint64_t n_elec = 0;
+    for (auto cnt : kept_elec) n_elec += cnt;
+
+    this->Carriers.swap(new_carriers);
+    this->num_elec = n_elec;
+    this->num_hole = this->Carriers.size() - n_elec;
+
+    return n_carr - this->Carriers.size();
 }
 
 // Is the carrier inside?
@@ -216,12 +262,16 @@ bool sim_space::is_collectable(const spCarrier& carrier, const Loc& prev_pos)
 
 
 // Registers carriers to remove
-// --> neglect input carrier if it is already registered and returns 0
-// other than that, returns the index of carrier at CarriersToRemove
+// --> Each thread writes to its own buffer so no locking needed.
+// Marking the same carrier twice is harmless.
 //
-int sim_space::add_to_rem(const spCarrier& carrier)
+int sim_space::add_to_rem(const uint64_t& carr_index)
 {
-    this->CarriersToRemove.insert(carrier);
+    uint64_t ith = 0;
+#ifdef _OPENMP
+    ith = omp_get_thread_num();
+#endif
+    this->CarriersToRemove[ith].push_back(carr_index);
 
     return 0;
 }
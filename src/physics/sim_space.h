@@ -16,9 +16,23 @@
 #include <omp.h>
 #endif
 
+#include <random>
+
 // Default process number.
 #define PROCESS_NUM 4
 
+// Default seed for simulation random number generator.
+#define SIM_RNG_SEED 20161006
+
+// Carrier status after position update
+static const int CARR_STAY = 0;
+static const int CARR_COLLECTED = 1;
+static const int CARR_LOST = 2;
+
+// Per carrier random streams (sim_space::CarrierRng)
+static const uint64_t RNG_STREAM_MFP = 1;
+static const uint64_t RNG_STREAM_DIFFUSION = 2;
+
 // Boost filesystem settings
 #define BOOST_FILESYSTEM_NO_DEPRECATED
 
@@ -32,6 +46,7 @@
 #include "readcsv.h"
 #include "pbar.h"
 #include "decor_output.h"
+#include "omp_team.h"
 
 /**
  * Struct Bias
@@ -61,8 +76,9 @@ public:
     // vector of Carriers. Populate it with
     // private method generate_carriers
     CarrierList Carriers;
-    //CarrierList CarriersToRemove;
-    CarrierSet CarriersToRemove;
+
+    // Carriers to remove (indices at Carriers), one buffer per thread.
+    std::vector<CarrierIndexList> CarriersToRemove;
 
     // Material dimension (silicon dimension... mostly)
     std::unique_ptr<Box> silicon_dimension;
@@ -96,6 +112,36 @@ public:
     // number of sim processes
     unsigned int processes;
 
+    // Team size of per step OpenMP regions
+    OmpTeamPolicy OmpPolicy;
+    void SetOmpPolicy(
+        const uint64_t& serial_below,
+        const uint64_t& min_items,
+        const double& min_work_us)
+    { this->OmpPolicy.Set(serial_below, min_items, min_work_us); }
+
+    // Random number generator for carrier sampling.
+    std::mt19937_64 sim_rng;
+    void SetRandomSeed(const uint64_t& seed)
+    { this->sim_rng.seed(seed); this->rng_seed = seed; }
+
+    // Per carrier streams for MFPAdj and Diffusion, rebuilt from
+    // (rng_seed, rng_pass, carrier index, stream) at every use.
+    // --> Independent of thread schedule and restored from two integers.
+    uint64_t rng_seed;
+    uint64_t rng_pass;
+    SplitMix64 CarrierRng(
+        const spCarrier& carrier, const uint64_t& stream) const
+    {
+        return SplitMix64(
+            SplitMix64::mix(this->rng_seed ^
+                SplitMix64::mix(this->rng_pass ^
+                    SplitMix64::mix(carrier->GetIndex() ^
+                        (stream << 32)))));
+    }
+    // Called once per drift pass
+    void NextRngPass() { ++this->rng_pass; }
+
     // Progress Bars
     ProgressBar CarrierReadInProgress;
     ProgressBar ForceCal;
@@ -105,17 +151,19 @@ public:
     void SetNormFactor(
         const fp_t& nx, const fp_t& ny, const fp_t& nz);
 
-    // populate carriers to remove
-    int add_to_rem(const spCarrier& carrier);
+    // Prepares removal buffers for current number of threads.
+    void init_rem();
+
+    // populate carriers to remove (index at Carriers)
+    // --> thread safe, each thread has its own buffer.
+    int add_to_rem(const uint64_t& carr_index);
 
     // Returns volume as of cm^3
     fp_t GetVolume();
 
-    // Remove carrier from this->Carriers
-    int remove_carr(spCarrier& carrier);
-    // search carrier from this->Carriers
-    uint64_t search_carr(const spCarrier& carrier, uint64_t& index);
-    uint64_t search_rem_carr(const spCarrier& carrier);
+    // Removes carriers marked by add_to_rem at once and updates
+    // electron/hole counters. Returns number of removed carriers.
+    uint64_t remove_marked_carr();
 
     // Determines if a carrier is collectable or not.
     bool is_inside(const spCarrier& carrier);
@@ -153,6 +201,9 @@ public:
         len_scale_f(1.0),
         DetMaterial(Materials::MatData()),
         NormFactor({1.0, 1.0, 1.0}),
+        sim_rng(SIM_RNG_SEED),
+        rng_seed(SIM_RNG_SEED),
+        rng_pass(0),
         CarrierReadInProgress(ProgressBar()),
         ForceCal(ProgressBar()),
         LocCal(ProgressBar())
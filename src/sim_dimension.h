@@ -12,6 +12,7 @@
 #define __sim_dimension_h__
 
 #include "sim_space.h"
+#include "Utils.h"
 
 /****************************************************************************/
 /***** Fix this area if you wish to change default parameters ***************/
@@ -49,4 +50,26 @@ const std::string MAT_DB_FILE = "src/database/Materials.db";
 const Box DIM_BOX = Box{ X_START, X_END, Y_START, Y_END, Z_START, Z_END };
 const Bias BIAS_DEF = Bias{ BIAS_ANODE, BIAS_CATHODE };
 
+// Parses x<x_start>:<x_end>y<y_start>:<y_end>z<z_start>:<z_end>
+inline Box ParseBox(const std::string& box_str)
+{
+    auto x_ind = box_str.find_first_of("x");
+    auto y_ind = box_str.find_first_of("y");
+    auto z_ind = box_str.find_first_of("z");
+    auto x_portion = box_str.substr(x_ind+1, y_ind);
+    auto y_portion = box_str.substr(y_ind+1, z_ind);
+    auto z_portion = box_str.substr(z_ind+1);
+    auto x_colon = x_portion.find_first_of(":");
+    auto y_colon = y_portion.find_first_of(":");
+    auto z_colon = z_portion.find_first_of(":");
+    auto x_start = str_to_num<fp_t>(x_portion.substr(0, x_colon));
+    auto x_end = str_to_num<fp_t>(x_portion.substr(x_colon+1));
+    auto y_start = str_to_num<fp_t>(y_portion.substr(0, y_colon));
+    auto y_end = str_to_num<fp_t>(y_portion.substr(y_colon+1));
+    auto z_start = str_to_num<fp_t>(z_portion.substr(0, z_colon));
+    auto z_end = str_to_num<fp_t>(z_portion.substr(z_colon+1));
+
+    return Box{ x_start, x_end, y_start, y_end, z_start, z_end };
+}
+
 #endif /* include guard */
\ No newline at end of file
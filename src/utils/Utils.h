@@ -15,6 +15,9 @@
 #include <algorithm>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <random>
+#include <unordered_set>
 
 #include <fputils.h>
 
@@ -84,10 +87,49 @@ template <typename T>
 static __tuple_3D__<T> UnitVec3D()
 {
 	T costheta = uniform_rand<T>(T(-1.0), T(1.0));
-	T phi = T(2.0) * static_cast<T>(M_PI);
+	T phi = fp_randn<T>(T(2.0) * static_cast<T>(M_PI));
 	T theta = acos(costheta);
 
     return __tuple_3D__<T>( sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta) );
 }
 
+template <typename T, typename RNG>
+static __tuple_3D__<T> UnitVec3D(RNG& rng)
+{
+	T costheta = uniform_rand<T>(rng, T(-1.0), T(1.0));
+	T phi = fp_randn<T>(rng, T(2.0) * static_cast<T>(M_PI));
+	T theta = acos(costheta);
+
+    return __tuple_3D__<T>( sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta) );
+}
+
+/**
+ *
+ * Picks k distinct indices out of [0, n) uniformly.
+ * --> Robert Floyd's sampling algorithm. O(k) expected time.
+ *
+**/
+template <typename RNG>
+static std::vector<uint64_t> sample_indices(
+    const uint64_t& n, const uint64_t& k, RNG& rng)
+{
+    std::vector<uint64_t> picked;
+    if (!k || k > n) return picked;
+
+    std::unordered_set<uint64_t> picked_set;
+    picked.reserve(k);
+    picked_set.reserve(k);
+
+    for (uint64_t j = n - k; j < n; ++j) {
+        auto t = std::uniform_int_distribution<uint64_t>(0, j)(rng);
+        if (!picked_set.insert(t).second) {
+            t = j;
+            picked_set.insert(j);
+        }
+        picked.push_back(t);
+    }
+
+    return picked;
+}
+
 #endif /* Include guard */
\ No newline at end of file
@@ -29,6 +29,16 @@
 /* Uncomment below to enable boost::multiprecision */
 //#define __MULTIPRECISION__
 
+/* Uncomment below to enable compensated (Kahan) summation of forces,
+ * positions and elapsed time. Everything else stays in hardware
+ * double, so it costs a few flops per update instead of the software
+ * arithmetic of __MULTIPRECISION__. */
+//#define __COMPENSATED__
+
+#if defined(__MULTIPRECISION__) && defined(__COMPENSATED__)
+    #error "__COMPENSATED__ and __MULTIPRECISION__ don't mix!!"
+#endif
+
 #ifdef __MULTIPRECISION__
     #include <boost/multiprecision/cpp_int.hpp>
     #include <boost/multiprecision/cpp_bin_float.hpp>
@@ -209,6 +219,35 @@ T fp_min(const T& A, const T& B, Ts&&... vs)
         return fp_min<T>(B, std::forward<Ts>(vs)...);
 }
 
+/**
+ *
+ * Compensated summation
+ *
+**/
+// sum += x, Kahan style: the rounding error of every addition goes to
+// c and is taken off the next addend, so sum stays within an ulp of
+// the exact total.
+template <typename T>
+inline void fp_kahan_add(T& sum, T& c, const T& x)
+{
+    T y = x - c;
+    T t = sum + y;
+    c = (t - sum) - y;
+    sum = t;
+}
+
+// sum += x, TwoSum style: exact rounding error of the addition is added
+// up in c, exact total is sum + c. Branch free, and sum and c of
+// SIMD or OpenMP lanes can be reduced separately, unlike fp_kahan_add.
+template <typename T>
+inline void fp_two_sum_add(T& sum, T& c, const T& x)
+{
+    T t = sum + x;
+    T bp = t - sum;
+    c += (sum - (t - bp)) + (x - bp);
+    sum = t;
+}
+
 /**
  *
  * Cartesian 2D struct
@@ -412,12 +451,9 @@ struct __tuple_3D__ {
         this->y = y_in;
         this->z = z_in;
     }
-    __tuple_3D__(const __tuple_3D__& other)
-    {
-        this->x = other.x;
-        this->y = other.y;
-        this->z = other.z;
-    }
+    // Trivial copy: keeps records holding tuples memcpy-able.
+    __tuple_3D__(const __tuple_3D__& other) = default;
+    __tuple_3D__& operator=(const __tuple_3D__& other) = default;
 
     // Some operator overloads for cartessian tuple struct
 
@@ -879,4 +915,59 @@ T fp_randn(const T& max)
     return static_cast<T>(fp_rand()) * max;
 }
 
+/**
+ *
+ * SplitMix64: small counter based generator for per carrier streams.
+ *
+ * --> 8 bytes of state, cheap to build from a hashed seed on the spot.
+ *
+**/
+struct SplitMix64
+{
+    uint64_t state;
+
+    // Finalizer, also used to hash seeds together
+    static uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t next()
+    {
+        this->state += 0x9E3779B97F4A7C15ULL;
+        return mix(this->state);
+    }
+
+    // 0 to 1 (53 bits)
+    double uniform()
+    {
+        return static_cast<double>(this->next() >> 11) * \
+            (1.0/9007199254740992.0);
+    }
+
+    SplitMix64(const uint64_t& seed) : state(seed) {;}
+};
+
+// Same as above with a given generator (anything with uniform())
+template <typename T, typename RNG>
+T uniform_rand(RNG& rng, const T& min, const T& max)
+{
+    if (fp_mt<T>(min, max)) \
+        return \
+            static_cast<T>(
+                rng.uniform())*(min-max)-(min-max)/static_cast<T>(2.0);
+    else
+        return \
+            static_cast<T>(
+                rng.uniform())*(max-min)-(max-min)/static_cast<T>(2.0);
+}
+
+template <typename T, typename RNG>
+T fp_randn(RNG& rng, const T& max)
+{
+    return static_cast<T>(rng.uniform()) * max;
+}
+
 #endif /* Include guard */
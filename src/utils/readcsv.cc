@@ -119,7 +119,7 @@ str_list ReadData::get(__str__ key)
 __str__ ReadData::get(__str__ key, int64_t index)
 {
     auto key_pos = this->search_me(key);
-    if (key_pos > -1) return this->table[key_pos]->getdata()[index];
+    if (key_pos > -1) return this->table[key_pos]->Get(index);
     else return __str__("");
 }
 
@@ -8,6 +8,9 @@
  *
 **/
 
+#include <ctime>
+#include <cstring>
+
 #include "untar.h"
 
 // Converts std::string to lowercase
@@ -190,3 +193,77 @@ int untarFile(const char* inputFilename, std::string& csvData)
     fin.close();
     return 0;
 }
+
+/**
+ * Writes a single file tarball (tar.gz, tar.bz2 or plain tar)
+ *
+ * Just enough USTAR to be read back by untarFile() or GNU tar.
+ *
+**/
+int tarFile(
+    const char* outputFilename,
+    const std::string& memberName,
+    const std::string& fileData)
+{
+    std::ofstream fout(outputFilename, std::ios_base::out | std::ios_base::binary);
+    if (!fout.is_open()) {
+        std::cerr << "tarFile: Cannot open " << outputFilename << std::endl;
+        return -1;
+    }
+
+    filtering_ostream out;
+    std::string filename(outputFilename);
+    if (boost::algorithm::iends_with(lowercase(filename), ".gz") || \
+        boost::algorithm::iends_with(lowercase(filename), ".tgz")) {
+        out.push(gzip_compressor());
+    }
+    else if (boost::algorithm::iends_with(lowercase(filename), ".bz2")) {
+        out.push(bzip2_compressor());
+    }
+    else if (!boost::algorithm::iends_with(lowercase(filename), ".tar")) {
+        std::cerr << "tarFile: Uh oh, wrong file suffix!! only .tar.gz, tar.bz2, or .tar are valid!!" << std::endl;
+        return -1;
+    }
+    out.push(fout);
+
+    if (memberName.size() >= 100) {
+        std::cerr << "tarFile: Member name is too long: " << memberName << std::endl;
+        return -1;
+    }
+
+    TARFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.filename, memberName.c_str(), memberName.size());
+    snprintf(header.mode, sizeof(header.mode), "%07o", 0644);
+    snprintf(header.uid, sizeof(header.uid), "%07o", 0);
+    snprintf(header.gid, sizeof(header.gid), "%07o", 0);
+    snprintf(header.filesize, sizeof(header.filesize), "%011llo",
+        static_cast<unsigned long long>(fileData.size()));
+    snprintf(header.lastModification, sizeof(header.lastModification), "%011llo",
+        static_cast<unsigned long long>(std::time(nullptr)));
+    header.typeFlag = '0';
+    memcpy(header.ustarIndicator, "ustar", 6);
+    memcpy(header.ustarVersion, "00", 2);
+
+    // Checksum is taken with the checksum field filled with spaces.
+    memset(header.checksum, ' ', sizeof(header.checksum));
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < sizeof(TARFileHeader); ++i)
+        checksum += ((unsigned char*) &header)[i];
+    snprintf(header.checksum, sizeof(header.checksum), "%06llo",
+        static_cast<unsigned long long>(checksum));
+
+    char zeroBlock[1024];
+    memset(zeroBlock, 0, 1024);
+
+    out.write((char*) &header, 512);
+    out.write(fileData.data(), fileData.size());
+    out.write(zeroBlock, (512 - (fileData.size() % 512)) % 512);
+    // End of archive: two zero blocks
+    out.write(zeroBlock, 1024);
+
+    // Flushes compressor before the file goes away.
+    out.reset();
+    fout.close();
+    return 0;
+}
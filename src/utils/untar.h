@@ -67,6 +67,15 @@ static uint64_t decodeTarOctal(char* data, size_t size = 12)
 **/
 int untarFile(const char* inputFilename, std::string& csvData);
 
+/**
+ * Writes a single file tarball (tar.gz, tar.bz2 or plain tar)
+ *
+**/
+int tarFile(
+	const char* outputFilename,
+	const std::string& memberName,
+	const std::string& fileData);
+
 /**
  * Defining struct to maintain TAR fileheader
  *